@@ -0,0 +1,164 @@
+//
+// nooverlap_bench.cpp
+// Microbenchmark for the no-overlap pair tests: the pair-at-a-time loop of NoOverlap against the
+// structure-of-arrays kernel in nooverlap_kernel.hpp.
+//
+// Does not need Gecode, compile for example with:
+// g++ -O3 -march=native nooverlap_bench.cpp -o bin/nooverlap_bench
+// ./bin/nooverlap_bench [repetitions]
+// The crossover of the speedup column is what NoOverlapKernel::threshold is set from for each instruction set.
+//
+
+#include "nooverlap_kernel.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+/**
+ * Bounds of one coordinate as the propagator sees it through a view: min and max are loaded per pair.
+ */
+struct Coordinate {
+    int lo, hi;
+
+    int min(void) const {
+        return lo;
+    }
+
+    int max(void) const {
+        return hi;
+    }
+};
+
+/**
+ * Random instance shaped like the square packing model: squares of size n ... 2 with coordinate domains inside
+ * [0, s - size] and random (partly fixed) bounds.
+ */
+struct Instance {
+    int n;
+    std::vector<Coordinate> x, y;
+    std::vector<int> w, h;
+
+    Instance(int n0, int s, unsigned int seed) : n(n0), x(n0), y(n0), w(n0), h(n0) {
+        std::srand(seed);
+        for (int i = 0; i < n; ++i) {
+            w[i] = h[i] = n + 1 - i;
+            int lim = s - w[i];
+            int a = std::rand() % (lim + 1), b = std::rand() % (lim + 1);
+            x[i].lo = std::min(a, b);
+            x[i].hi = std::max(a, b);
+            a = std::rand() % (lim + 1);
+            b = std::rand() % (lim + 1);
+            y[i].lo = std::min(a, b);
+            y[i].hi = std::max(a, b);
+            //Narrow some domains so that compulsory parts exist
+            if (i % 3 == 0) {
+                x[i].hi = std::min(x[i].hi, x[i].lo + w[i] / 2);
+                y[i].hi = std::min(y[i].hi, y[i].lo + h[i] / 2);
+            }
+        }
+    }
+};
+
+// Read once per call, keeps the compiler from hoisting the repeated calls out of the timing loops
+volatile int noise = 0;
+
+/**
+ * The tests as done by NoOverlap before the kernel: one pair at a time through the coordinates.
+ * Returns the number of pairs that must overlap on some axis or are disjoint, as a checksum.
+ */
+long reference(const Instance &I) {
+    const std::vector<Coordinate> &x = I.x, &y = I.y;
+    const std::vector<int> &w = I.w, &h = I.h;
+    long count = noise;
+    for (int i = 0; i < I.n; ++i)
+        for (int j = i + 1; j < I.n; ++j) {
+            if ((x[i].max() <= x[j].min() && x[i].min() + w[i] > x[j].max()) ||
+                (x[j].max() <= x[i].min() && x[j].min() + w[j] > x[i].max()))
+                count++;
+            if ((y[i].max() <= y[j].min() && y[i].min() + h[i] > y[j].max()) ||
+                (y[j].max() <= y[i].min() && y[j].min() + h[j] > y[i].max()))
+                count++;
+            if ((x[i].max() + w[i] <= x[j].min()) || (x[j].max() + w[j] <= x[i].min()) ||
+                (y[i].max() + h[i] <= y[j].min()) || (y[j].max() + h[j] <= y[i].min()))
+                count++;
+        }
+    return count;
+}
+
+// Number of set bits
+int popcount(unsigned int m) {
+    int c = 0;
+    for (; m != 0; m &= m - 1)
+        c++;
+    return c;
+}
+
+/**
+ * The same tests with the kernel, including copying the bounds into the arrays as the propagator does once per
+ * propagation. Only partners j > i are counted, like the active-pair rows.
+ */
+long kernel(const Instance &I, std::vector<int> &store) {
+    int n = I.n, p = NoOverlapKernel::padded(n);
+    store.assign(6 * p, 0);
+    NoOverlapKernel::Bounds s;
+    s.xmin = &store[0];
+    s.xmax = &store[p];
+    s.w = &store[2 * p];
+    s.ymin = &store[3 * p];
+    s.ymax = &store[4 * p];
+    s.h = &store[5 * p];
+    for (int i = 0; i < n; ++i) {
+        s.xmin[i] = I.x[i].min();
+        s.xmax[i] = I.x[i].max();
+        s.w[i] = I.w[i];
+        s.ymin[i] = I.y[i].min();
+        s.ymax[i] = I.y[i].max();
+        s.h[i] = I.h[i];
+    }
+    long count = noise;
+    for (int i = 0; i < n; ++i)
+        for (int k = i / NoOverlapKernel::block; k < NoOverlapKernel::words(n); ++k) {
+            //Partners j > i and j < n
+            int first = i + 1 - k * NoOverlapKernel::block, last = n - k * NoOverlapKernel::block;
+            unsigned int valid = ~0u;
+            if (first > 0)
+                valid = first < NoOverlapKernel::block ? valid << first : 0;
+            if (last < NoOverlapKernel::block)
+                valid &= (1u << last) - 1;
+            NoOverlapKernel::Masks m = NoOverlapKernel::word(s, i, k);
+            count += popcount(m.xForced & valid) + popcount(m.yForced & valid) + popcount(m.disjoint & valid);
+        }
+    return count;
+}
+
+int main(int argc, char *argv[]) {
+    int repetitions = argc > 1 ? std::atoi(argv[1]) : 2000;
+    std::cout << "NoOverlap uses the kernel from n = " << NoOverlapKernel::threshold << std::endl;
+    std::cout << "n\tpairs\treference(ns/pair)\tkernel(ns/pair)\tspeedup" << std::endl;
+    for (int n = 8; n <= 128; n += (n < 48 ? 4 : 16)) {
+        //Enclosing square about as large as for the packing problem of size n
+        Instance I(n, (n * 2) / 3 + n, 42 + n);
+        std::vector<int> store;
+        long pairs = static_cast<long>(n) * (n - 1) / 2;
+
+        long checkRef = 0, checkKernel = 0;
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        for (int r = 0; r < repetitions; ++r)
+            checkRef += reference(I);
+        std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+        for (int r = 0; r < repetitions; ++r)
+            checkKernel += kernel(I, store);
+        std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+
+        if (checkRef != checkKernel) {
+            std::cerr << "Mismatch for n = " << n << ": " << checkRef << " != " << checkKernel << std::endl;
+            return 1;
+        }
+        double ref = std::chrono::duration<double, std::nano>(t1 - t0).count() / (repetitions * pairs);
+        double ker = std::chrono::duration<double, std::nano>(t2 - t1).count() / (repetitions * pairs);
+        std::cout << n << "\t" << pairs << "\t" << ref << "\t" << ker << "\t" << ref / ker << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,184 @@
+//
+// nooverlap_kernel.hpp
+// Structure-of-arrays kernel for the pairwise tests of the no-overlap propagator.
+//
+// The bounds of all squares are copied once into contiguous arrays, and the "must overlap" and "can never overlap"
+// predicates of one square against 32 partner squares are evaluated at once and returned as bit masks (bit b of
+// word k stands for partner k * 32 + b, the same layout as the active-pair rows of NoOverlap).
+// With AVX2 eight partners are compared per instruction, with SSE2 four, otherwise a scalar loop is used.
+// Below threshold squares the propagator keeps testing one pair at a time, which is faster there.
+// The kernel does not depend on Gecode, so it can be benchmarked on its own (see nooverlap_bench.cpp).
+//
+
+#ifndef NOOVERLAP_KERNEL_HPP
+#define NOOVERLAP_KERNEL_HPP
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace NoOverlapKernel {
+
+    // Number of partner squares per mask word
+    const int block = 32;
+
+    /**
+     * Bounds of all squares as structure of arrays. The arrays must have room for padded(n) entries, entries
+     * beyond n are only read and never reported since the caller masks them out.
+     */
+    struct Bounds {
+        int *xmin, *xmax, *w;
+        int *ymin, *ymax, *h;
+    };
+
+    // Number of entries to allocate per array for n squares (whole mask words)
+    inline int padded(int n) {
+        return ((n + block - 1) / block) * block;
+    }
+
+    // Number of mask words for n squares
+    inline int words(int n) {
+        return (n + block - 1) / block;
+    }
+
+    /**
+     * Masks of square i against one partner word.
+     */
+    struct Masks {
+        // Partners whose x-projection must overlap the x-projection of i
+        unsigned int xForced;
+        // Partners whose y-projection must overlap the y-projection of i
+        unsigned int yForced;
+        // Partners that can never overlap i
+        unsigned int disjoint;
+    };
+
+    /**
+     * Scalar evaluation of the predicates for square i and partner j, sets bit b of the masks.
+     * This is the reference for the vector versions below.
+     */
+    inline void scalar(const Bounds &s, int i, int j, int b, Masks &m) {
+        if ((s.xmax[i] <= s.xmin[j] && s.xmin[i] + s.w[i] > s.xmax[j]) ||
+            (s.xmax[j] <= s.xmin[i] && s.xmin[j] + s.w[j] > s.xmax[i]))
+            m.xForced |= 1u << b;
+        if ((s.ymax[i] <= s.ymin[j] && s.ymin[i] + s.h[i] > s.ymax[j]) ||
+            (s.ymax[j] <= s.ymin[i] && s.ymin[j] + s.h[j] > s.ymax[i]))
+            m.yForced |= 1u << b;
+        if ((s.xmax[i] + s.w[i] <= s.xmin[j]) || (s.xmax[j] + s.w[j] <= s.xmin[i]) ||
+            (s.ymax[i] + s.h[i] <= s.ymin[j]) || (s.ymax[j] + s.h[j] <= s.ymin[i]))
+            m.disjoint |= 1u << b;
+    }
+
+#if defined(__AVX2__)
+    typedef __m256i Vec;
+    const int lanes = 8;
+    // Fewest squares for which word() beats the pair-at-a-time loop (nooverlap_bench.cpp, -O2 -mavx2)
+    const int threshold = 44;
+
+    inline Vec load(const int *a) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a));
+    }
+    inline Vec broadcast(int v) {
+        return _mm256_set1_epi32(v);
+    }
+    inline Vec add(Vec a, Vec b) {
+        return _mm256_add_epi32(a, b);
+    }
+    inline Vec gr(Vec a, Vec b) {
+        return _mm256_cmpgt_epi32(a, b);
+    }
+    inline Vec both(Vec a, Vec b) {
+        return _mm256_and_si256(a, b);
+    }
+    inline Vec either(Vec a, Vec b) {
+        return _mm256_or_si256(a, b);
+    }
+    // a and not b
+    inline Vec butnot(Vec a, Vec b) {
+        return _mm256_andnot_si256(b, a);
+    }
+    inline Vec ones(void) {
+        return _mm256_set1_epi32(-1);
+    }
+    inline unsigned int bits(Vec a) {
+        return static_cast<unsigned int>(_mm256_movemask_ps(_mm256_castsi256_ps(a)));
+    }
+#elif defined(__SSE2__)
+    typedef __m128i Vec;
+    const int lanes = 4;
+    // Fewest squares for which word() beats the pair-at-a-time loop (nooverlap_bench.cpp, -O2)
+    const int threshold = 64;
+
+    inline Vec load(const int *a) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i *>(a));
+    }
+    inline Vec broadcast(int v) {
+        return _mm_set1_epi32(v);
+    }
+    inline Vec add(Vec a, Vec b) {
+        return _mm_add_epi32(a, b);
+    }
+    inline Vec gr(Vec a, Vec b) {
+        return _mm_cmpgt_epi32(a, b);
+    }
+    inline Vec both(Vec a, Vec b) {
+        return _mm_and_si128(a, b);
+    }
+    inline Vec either(Vec a, Vec b) {
+        return _mm_or_si128(a, b);
+    }
+    // a and not b
+    inline Vec butnot(Vec a, Vec b) {
+        return _mm_andnot_si128(b, a);
+    }
+    inline Vec ones(void) {
+        return _mm_set1_epi32(-1);
+    }
+    inline unsigned int bits(Vec a) {
+        return static_cast<unsigned int>(_mm_movemask_ps(_mm_castsi128_ps(a)));
+    }
+#else
+    // The scalar word() is slower than the pair-at-a-time loop for every benchmarked size, so it is never used
+    const int threshold = 1 << 30;
+#endif
+
+    /**
+     * Evaluate the predicates of square i against the partners k * 32 ... k * 32 + 31.
+     */
+    inline Masks word(const Bounds &s, int i, int k) {
+        Masks m;
+        m.xForced = m.yForced = m.disjoint = 0;
+#if defined(__AVX2__) || defined(__SSE2__)
+        // Square i, broadcast to all lanes
+        Vec ixmin = broadcast(s.xmin[i]), ixmax = broadcast(s.xmax[i]);
+        Vec iymin = broadcast(s.ymin[i]), iymax = broadcast(s.ymax[i]);
+        Vec ixend = broadcast(s.xmin[i] + s.w[i]), iyend = broadcast(s.ymin[i] + s.h[i]);
+        Vec ixlast = broadcast(s.xmax[i] + s.w[i]), iylast = broadcast(s.ymax[i] + s.h[i]);
+        for (int b = 0; b < block; b += lanes) {
+            int j = k * block + b;
+            Vec jxmin = load(s.xmin + j), jxmax = load(s.xmax + j), jw = load(s.w + j);
+            Vec jymin = load(s.ymin + j), jymax = load(s.ymax + j), jh = load(s.h + j);
+            // a <= b is computed as not (a > b)
+            Vec xForced = either(butnot(gr(ixend, jxmax), gr(ixmax, jxmin)),
+                                 butnot(gr(add(jxmin, jw), ixmax), gr(jxmax, ixmin)));
+            Vec yForced = either(butnot(gr(iyend, jymax), gr(iymax, jymin)),
+                                 butnot(gr(add(jymin, jh), iymax), gr(jymax, iymin)));
+            // Disjoint unless the envelopes intersect on both axes
+            Vec reach = both(both(gr(ixlast, jxmin), gr(add(jxmax, jw), ixmin)),
+                             both(gr(iylast, jymin), gr(add(jymax, jh), iymin)));
+            m.xForced |= bits(xForced) << b;
+            m.yForced |= bits(yForced) << b;
+            m.disjoint |= bits(butnot(ones(), reach)) << b;
+        }
+#else
+        for (int b = 0; b < block; ++b)
+            scalar(s, i, k * block + b, b, m);
+#endif
+        return m;
+    }
+
+}
+
+#endif
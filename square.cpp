@@ -3,19 +3,61 @@
 #include <gecode/driver.hh>
 #include <gecode/minimodel.hh> //rel
 
+#include "square_gaps.hpp"
+#include "thread_count.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
 using namespace Gecode;
 
-int n;
+/**
+ * SizeOptions with -dimensions for the batch runner, which uses all cores unless -threads is given
+ */
+class SquareOptions : public SizeOptions {
+protected:
+    Driver::StringValueOption _dimensions;
+public:
+    SquareOptions(const char* s) : SizeOptions(s),
+        _dimensions("-dimensions", "solve these N >= 2 in parallel, one process each, -threads at a time (default all cores), list and ranges (e.g. 2-20,25)") {
+        add(_dimensions);
+    }
 
-class Square : public Script {
+    const char* dimensions(void) const {
+        return _dimensions.value();
+    }
+
+    void parse(int& argc, char* argv[]) {
+        bool threadsGiven = false;
+        for (int i = 1; i < argc; i++)
+            threadsGiven = threadsGiven || !strcmp(argv[i], "-threads") || !strcmp(argv[i], "--threads");
+        SizeOptions::parse(argc, argv);
+        if ((dimensions() != NULL) && !threadsGiven)
+            threads(0.0);
+    }
+};
+
+class Square : public IntMinimizeScript {
 public:
 //task 1 
+    const int n;    // number of squares, per instance so that several dimensions can be solved at once
     IntVar s;       // size of square
     IntVarArray xCor,yCor;  // xCor coordinates yCor coordinates
 
 
-    //static function for size task 1 
-    static int size(int i){
+    //function for size task 1 
+    int size(int i) const {
         return n-i;
     }
     //to put a value constraint so that xCor cor and yCor cor are equal to n 
@@ -27,7 +69,9 @@ public:
         return sum;
     }
     
-    Square(const SizeOptions& opt): Script(opt), xCor(*this, n, 0, sumLength(n)), yCor(*this, n, 0 , sumLength(n)) {
+    Square(const SizeOptions& opt): Square(opt, opt.size()) {}
+
+    Square(const SizeOptions& opt, int n0): IntMinimizeScript(opt), n(n0), xCor(*this, n, 0, sumLength(n)), yCor(*this, n, 0 , sumLength(n)) {
              
         s = IntVar(*this, floor(sqrt(n*(n+1)*(2*n+1)/6)), sumLength(n)); //nsqa sum
 
@@ -44,27 +88,15 @@ public:
             sizes[i] = size(i);
         }
         
-        //task 2 no pverlap reification constaint
-        for (int i=0; i<n-1; i++) {
-            for(int j=i+1; j<n-1; j++){
-                IntVar LEFT(*this,0, sumLength(n)+size(i));
-                IntVar RIGHT(*this,0, sumLength(n)+size(j));
-                IntVar ABOVE(*this,0, sumLength(n)+size(i));
-                IntVar BELOW(*this,0, sumLength(n)+size(j));
-                
-                BoolVarArgs b(*this,4,0,1);               
-
-                rel(*this, LEFT == xCor[i]+size(i));
-                rel(*this, RIGHT == xCor[j]+size(j));
-                rel(*this, ABOVE == yCor[i]+size(i));
-                rel(*this, BELOW == yCor[j]+size(j));
-                rel(*this, LEFT, IRT_LQ, xCor[j], b[0]);
-                rel(*this, RIGHT, IRT_LQ, xCor[i], b[1]); //reifiied
-                rel(*this, ABOVE, IRT_LQ, yCor[j], b[2]);
-                rel(*this, BELOW, IRT_LQ, yCor[i], b[3]);                
-                linear(*this, b, IRT_GQ, 1);
-            }
-        }  
+        //task 2 no overlap, one propagator over all pairs instead of auxiliary variables and reified rel per pair
+        IntVarArgs x(n-1), y(n-1);
+        IntArgs w(n-1);
+        for (int i = 0; i < n-1; i++) {
+            x[i] = xCor[i];
+            y[i] = yCor[i];
+            w[i] = size(i);
+        }
+        nooverlap(*this, x, w, y, w);
         //task3 parsing all columns and rows s.max()
         for(int k=0; k<s.max(); k++){
             BoolVarArgs xsum(*this,n,0,1);
@@ -82,30 +114,14 @@ public:
         rel(*this, xCor[0] <= 1+((s-size(0))/2));
         rel(*this, yCor[0] <= 1+((s-size(0))/2));
 
-        //task4 part 3 strip dominance initial domain reduction
-       if(n == 2) {
-            rel(*this, xCor[0], IRT_LE, 2);
-            rel(*this, yCor[0], IRT_LE, 2);
-        } else if (n == 3) {
-            rel(*this, xCor[0], IRT_LE, 3);
-            rel(*this, yCor[0], IRT_LE, 3);
-        } else if (n == 4) {
-            rel(*this, xCor[0], IRT_LE, 2);
-            rel(*this, yCor[0], IRT_LE, 2);
-        } else if(n >= 5 && n <= 8) {
-            rel(*this, xCor[0], IRT_LE, 3);
-            rel(*this, yCor[0], IRT_LE, 3);
-        } else if (n >= 9 && n <= 11) {
-            rel(*this, xCor[0], IRT_LE, 4);
-            rel(*this, yCor[0], IRT_LE, 4);
-        } else if(n >= 12 && n <= 17) {
-            rel(*this, xCor[0], IRT_LE, 5);
-            rel(*this, yCor[0], IRT_LE, 5);
-        } else if (n >= 18 && n <= 21) {
-            rel(*this, xCor[0], IRT_LE, 6);
-            rel(*this, yCor[0], IRT_LE, 6);
+        //task4 part 3 strip dominance initial domain reduction, gaps from square_gaps.hpp
+        //only up to the baseline range n <= 21, the gap is used as an upper bound here
+        int gap = SquareGaps::specific(n) >= 0 ? SquareGaps::specific(n) : SquareGaps::generic(n);
+        if (n <= 21 && gap >= 0) {
+            rel(*this, xCor[0], IRT_LE, gap);
+            rel(*this, yCor[0], IRT_LE, gap);
         }
-            
+
        //task 5 branching start from 
         branch(*this, s, INT_VAL_MIN());
         branch(*this, xCor, INT_VAR_NONE(), INT_VAL_MIN());
@@ -113,7 +129,7 @@ public:
     }
     
     /// Constructor for cloning
-    Square(bool share, Square& sq) : Script(share,sq) {
+    Square(bool share, Square& sq) : IntMinimizeScript(share,sq), n(sq.n) {
         xCor.update(*this, share, sq.xCor);
         yCor.update(*this, share, sq.yCor);
         s.update(*this, share, sq.s);
@@ -124,11 +140,16 @@ public:
     copy(bool share) {
         return new Square(share,*this);
     }
+
+    /// Cost to minimise, BAB posts s < s of the best packing after every solution
+    virtual IntVar cost(void) const {
+        return s;
+    }
     
     
     virtual void print(std::ostream& os) const {
         os << "\t";
-        os << "SIZE = " << s << std::endl << "\t";
+        os << "SIZE = " << s << " (new bound: s < " << s << ")" << std::endl << "\t";
         for (int i = 0; i < n; i++) {
             if (i!=n-1){
                 os  << size(i) << "\tPosition Coordinates (X,Y) " <<  xCor[i] << "," << yCor[i];
@@ -141,18 +162,177 @@ public:
     }
 };
 
+/**
+ * Parse a list of dimensions and ranges such as "2-20,25", false if it is malformed
+ */
+bool parseDimensions(const char* list, std::vector<int>& dims) {
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        std::stringstream is(item);
+        int lo, hi;
+        char dash;
+        if (!(is >> lo))
+            return false;
+        hi = lo;
+        if ((is >> dash) && ((dash != '-') || !(is >> hi)))
+            return false;
+        //nothing but blanks may follow, e.g. no "2-20x" or "2-3-4"
+        if (!(is >> std::ws).eof())
+            return false;
+        if ((lo < 2) || (hi < lo))
+            return false;
+        for (int d = lo; d <= hi; d++)
+            dims.push_back(d);
+    }
+    return !dims.empty();
+}
+
+/// Result of one dimension of the batch
+struct BatchRow {
+    int n;
+    int best;        // smallest size found, -1 if none
+    bool complete;   // search finished, best is optimal
+    bool failed;     // the process solving n did not report back
+    double time;
+    Search::Statistics statistics;
+    long peak;       // peak resident set size in KB of the process that solved n
+};
+
+/**
+ * Solve row.n with one sequential BAB, -time limits the search
+ */
+void solveRow(const SquareOptions& opt, BatchRow& row) {
+    Support::Timer t;
+    t.start();
+    Search::TimeStop stop(opt.time());
+    Search::Options so;
+    so.threads = 1;
+    so.c_d = opt.c_d();
+    so.a_d = opt.a_d();
+    so.clone = false;
+    if (opt.time() > 0)
+        so.stop = &stop;
+    BAB<Square> e(new Square(opt, row.n), so);
+    while (Square* sol = e.next()) {
+        row.best = sol->s.val();
+        delete sol;
+    }
+    row.complete = !e.stopped();
+    row.failed = false;
+    row.statistics = e.statistics();
+    row.time = t.stop();
+}
+
+/**
+ * Solve every dimension of -dimensions to optimality, each in its own child process with one sequential BAB,
+ * threadCount(-threads) dimensions at a time (all cores unless -threads is given), -time limits every dimension.
+ * The child sends its row through a pipe, and wait4() gives the peak memory of that dimension alone.
+ * Prints one row per N in the order given.
+ * @return false if -dimensions is malformed or some dimension failed
+ */
+bool batch(const SquareOptions& opt) {
+    std::vector<int> dims;
+    if (!parseDimensions(opt.dimensions(), dims)) {
+        std::cerr << "ERROR: -dimensions expects a list of dimensions >= 2 such as 2-20,25" << std::endl;
+        return false;
+    }
+    std::vector<BatchRow> rows(dims.size());
+    for (size_t k = 0; k < rows.size(); k++) {
+        rows[k].n = dims[k];
+        rows[k].best = -1;
+        rows[k].complete = false;
+        rows[k].failed = true;
+        rows[k].time = 0.0;
+        rows[k].peak = 0;
+    }
+    unsigned int workers = threadCount(opt.threads());
+    workers = std::min(workers, static_cast<unsigned int>(dims.size()));
+
+    //Running children: row index and read end of the pipe
+    std::map<pid_t, std::pair<size_t, int> > running;
+    size_t next = 0;
+    while ((next < dims.size()) || !running.empty()) {
+        if ((next < dims.size()) && (running.size() < workers)) {
+            int fd[2];
+            pid_t pid = -1;
+            if ((pipe(fd) != 0) || ((pid = fork()) < 0)) {
+                std::cerr << "ERROR: cannot start the search for N = " << dims[next] << std::endl;
+                next = dims.size();
+                continue;
+            }
+            if (pid == 0) {
+                close(fd[0]);
+                BatchRow row = rows[next];
+                solveRow(opt, row);
+                bool sent = write(fd[1], &row, sizeof(row)) == static_cast<ssize_t>(sizeof(row));
+                _exit(sent ? EXIT_SUCCESS : EXIT_FAILURE);
+            }
+            close(fd[1]);
+            running[pid] = std::make_pair(next++, fd[0]);
+            continue;
+        }
+        int status;
+        struct rusage usage;
+        pid_t pid = wait4(-1, &status, 0, &usage);
+        if ((pid < 0) && (errno == EINTR))
+            continue;
+        if (pid < 0)
+            break;
+        std::map<pid_t, std::pair<size_t, int> >::iterator child = running.find(pid);
+        if (child == running.end())
+            continue;
+        BatchRow& row = rows[child->second.first];
+        BatchRow sent;
+        //The row fits into the pipe buffer, so the child has written it completely before exiting
+        if (WIFEXITED(status) && (WEXITSTATUS(status) == EXIT_SUCCESS) &&
+            (read(child->second.second, &sent, sizeof(sent)) == static_cast<ssize_t>(sizeof(sent))))
+            row = sent;
+        else
+            std::cerr << "ERROR: the search for N = " << row.n << " did not finish" << std::endl;
+        row.peak = usage.ru_maxrss;
+        close(child->second.second);
+        running.erase(child);
+    }
+
+    bool ok = true;
+    std::cout << "N\tsize\tstatus\ttime(ms)\tnodes\tfailures\tdepth\tpeak RSS(KB)" << std::endl;
+    for (size_t k = 0; k < rows.size(); k++) {
+        const BatchRow& row = rows[k];
+        std::cout << row.n << "\t" << row.best << "\t"
+                  << (row.failed ? "failed" : (row.complete ? "optimal" : "stopped")) << "\t"
+                  << row.time << "\t" << row.statistics.node << "\t" << row.statistics.fail << "\t"
+                  << row.statistics.depth << "\t" << row.peak << std::endl;
+        ok = ok && !row.failed;
+    }
+    return ok;
+}
+
 int main(int argc, char* argv[]) {
-    SizeOptions opt("Square");
-    int N;
-    std::cout << "ENTER value of N" << std::endl; //let user specify no of square
-    std::cin >> N;
-    while(std::cin.fail() || N < 0) {
-        std::cout << "ERROR" << std::endl;
+    SquareOptions opt("Square");
+    //search until the best size is proven optimal, every improving packing is printed
+    opt.solutions(0);
+    opt.parse(argc,argv);
+    if (opt.dimensions() != NULL) {
+        //non-interactive, several dimensions
+        return batch(opt) ? 0 : EXIT_FAILURE;
+    }
+    if (opt.size() == 0) {
+        int N;
+        std::cout << "ENTER value of N" << std::endl; //let user specify no of square
         std::cin >> N;
+        while(std::cin.fail() || N < 0) {
+            std::cout << "ERROR" << std::endl;
+            std::cin >> N;
+        }
+        opt.size(N);
     }
-    opt.size(N);
-    n = opt.size();
-    opt.parse(argc,argv);
-    Script::run<Square,BAB,SizeOptions>(opt);
+    Script::run<Square,BAB,SquareOptions>(opt);
     return 0;
 }
+
+/**
+ * Example cmd:
+ * ./bin/square 12 -mode stat
+ * ./bin/square -dimensions 2-20,25 -threads 4 -time 60000
+ */
@@ -0,0 +1,50 @@
+//
+// square_gaps.hpp
+// Empty-strip dominance gaps by square size, shared by square.cpp and square_packing_with_overlap_and_interval.cpp.
+//
+// A square of size s placed at distance gap(s) from the border leaves an empty strip that cannot be used better than
+// by moving the square to the border, so that placement is dominated. The tables are the published gaps
+// 2: 2, 3-4: 2, 5-8: 3, 9-11: 4, 12-17: 5, 18-21: 6, 22-29: 7, 30-34: 8, 35-44: 9, 45: 10, entered by hand.
+// A gap that is not proven can exclude the only packings of the optimal s, so the tables stop at 45, the last
+// published size, and larger squares get no reduction (generic() and specific() return -1).
+//
+
+#ifndef SQUARE_GAPS_HPP
+#define SQUARE_GAPS_HPP
+
+namespace SquareGaps {
+
+    // Largest square size in the tables
+    constexpr int maxSize = 45;
+
+    // Gap of every square size, -1 if there is none
+    constexpr int genericTable[maxSize + 1] = {
+            -1, -1, 2, 2, 2, 3, 3, 3, 3, 4,
+            4, 4, 5, 5, 5, 5, 5, 5, 6, 6,
+            6, 6, 7, 7, 7, 7, 7, 7, 7, 7,
+            8, 8, 8, 8, 8, 9, 9, 9, 9, 9,
+            9, 9, 9, 9, 9, 10
+    };
+
+    // Additional gap of the smallest squares, -1 if there is none
+    constexpr int specificTable[maxSize + 1] = {
+            -1, -1, 2, 3, -1, -1, -1, -1, -1, -1,
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            -1, -1, -1, -1, -1, -1
+    };
+
+    // Gap of a square of the given size, -1 if there is none or size > maxSize
+    constexpr int generic(int size) {
+        return (size >= 0) && (size <= maxSize) ? genericTable[size] : -1;
+    }
+
+    // Additional gap of a square of the given size, -1 if there is none
+    constexpr int specific(int size) {
+        return (size >= 0) && (size <= maxSize) ? specificTable[size] : -1;
+    }
+
+}
+
+#endif
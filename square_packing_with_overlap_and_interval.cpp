@@ -4,6 +4,9 @@
 //
 
 #include <gecode/int.hh>
+#include <gecode/minimodel.hh>
+
+#include <vector>
 
 using namespace Gecode;
 
@@ -18,9 +21,9 @@ protected:
     // Views for x-coordinates (or y-coordinates)
     ViewArray <IntView> x;
     // Width (or height) of rectangles
-    int *w;
-    // Percentage for obligatory part
-    double p;
+    SharedArray<int> w;
+    // Obligatory part size of each rectangle (see interval() for the schedule)
+    SharedArray<int> o;
     // Cache of first unassigned view
     mutable int start;
 
@@ -29,8 +32,8 @@ protected:
     public:
         // Position of view
         int pos;
+        // Last value of the first alternative
         int split;
-        // You might need more information, please add here
 
         /* Initialize description for brancher b, number of
          *  alternatives a, position p, and split-mark.
@@ -43,10 +46,9 @@ protected:
             return sizeof(Description);
         }
 
-        // Archive the choice's information in e
+        // Archive the choice's information in e, read back by IntervalBrancher::choice(const Space&, Archive&)
         virtual void archive(Archive &e) const {
             Choice::archive(e);
-            // You must also archive the additional information
             e << pos << split;
         }
     };
@@ -54,21 +56,23 @@ protected:
 public:
     // Construct branching
     IntervalBrancher(Home home,
-                     ViewArray <IntView> &x0, int w0[], double p0)
-            : Brancher(home), x(x0), w(w0), p(p0), start(0) {}
+                     ViewArray <IntView> &x0, const SharedArray<int> &w0, const SharedArray<int> &o0)
+            : Brancher(home), x(x0), w(w0), o(o0), start(0) {
+        //Dispose must also run when the space is deleted, to release the shared width and obligatory part arrays
+        home.notice(*this, AP_DISPOSE);
+    }
 
     // Post branching
-    static void post(Home home, ViewArray <IntView> &x, int w[], double p) {
-        (void) new(home) IntervalBrancher(home, x, w, p);
+    static void post(Home home, ViewArray <IntView> &x, const SharedArray<int> &w, const SharedArray<int> &o) {
+        (void) new(home) IntervalBrancher(home, x, w, o);
     }
 
     // Copy constructor used during cloning of b
     IntervalBrancher(Space &home, bool share, IntervalBrancher &b)
-            : Brancher(home, share, b), p(b.p), start(b.start) {
+            : Brancher(home, share, b), start(b.start) {
         x.update(home, share, b.x);
-        w = home.alloc<int>(x.size());
-        for (int i = x.size(); i--;)
-            w[i] = b.w[i];
+        w.update(home, share, b.w);
+        o.update(home, share, b.o);
     }
 
     // Copy brancher
@@ -76,6 +80,15 @@ public:
         return new(home) IntervalBrancher(home, share, *this);
     }
 
+    // Dispose brancher and return its size
+    virtual size_t dispose(Space &home) {
+        home.ignore(*this, AP_DISPOSE);
+        w.~SharedArray();
+        o.~SharedArray();
+        (void) Brancher::dispose(home);
+        return sizeof(*this);
+    }
+
     // Check status of brancher, return true if alternatives left
     virtual bool status(const Space &home) const {
         for (int i = start; i < x.size(); ++i) {
@@ -84,9 +97,9 @@ public:
              */
             if (!x[i].assigned()) {
                 /**
-                 * If x-range has space for an obligatory part of size p*size then we can branch.
+                 * If x-range has space for an obligatory part of size o[i] then we can branch.
                  */
-                if ((x[i].min() + w[i] - std::ceil(p * w[i])) < x[i].max()) {
+                if ((x[i].min() + w[i] - o[i]) < x[i].max()) {
                     start = i; //update variable we are branching on
                     return true;
                 }
@@ -97,7 +110,7 @@ public:
 
     // Return choice as description
     virtual const Choice *choice(Space &home) {
-        int obligatoryPartSize = std::ceil(p * w[start]);
+        int obligatoryPartSize = o[start];
         int split = x[start].min() + w[start] - obligatoryPartSize;
         int noAlternatives = 2;
         /**
@@ -109,19 +122,18 @@ public:
         return new Description(*this, noAlternatives, start, split);
     }
 
-    // Construct choice from archive e
+    // Construct choice from archive e, in the order written by Description::archive
     virtual const Choice *choice(const Space &, Archive &e) {
-        // Again, you have to take care of the additional information
-        int alternative, split;
-        e >> alternative >> split;
-        return new Description(*this, alternative, p, split);
+        int pos, split;
+        e >> pos >> split;
+        return new Description(*this, 2, pos, split);
     }
 
     // Perform commit for choice c and alternative a
     virtual ExecStatus commit(Space &home, const Choice &c, unsigned int a) {
         const Description &d = static_cast<const Description &>(c);
         /**
-         * First alternative, interval [x.min, split], enforces obligatory part to be p % of side size.
+         * First alternative, interval [x.min, split], enforces obligatory part of size o[pos].
          */
         if (a == 0) {
             GECODE_ME_CHECK(x[d.pos].lq(home, d.split));
@@ -136,6 +148,15 @@ public:
         return ES_OK;
     }
 
+    // Return no-good literal for alternative a, so that restarts do not revisit explored intervals
+    virtual NGL *ngl(Space &home, const Choice &c, unsigned int a) const {
+        const Description &d = static_cast<const Description &>(c);
+        if (a == 0)
+            return new(home) Int::Branch::LqNGL<IntView>(home, x[d.pos], d.split);
+        else
+            return new(home) Int::Branch::GqNGL<IntView>(home, x[d.pos], d.split + 1);
+    }
+
     // Print some information on stream o (used by Gist, from Gecode 4.0.1 on)
     virtual void print(const Space &home, const Choice &c, unsigned int b,
                        std::ostream &o) const {
@@ -154,8 +175,11 @@ public:
     }
 };
 
-// This posts the interval branching
-void interval(Home home, const IntVarArgs &x, const IntArgs &w, double p) {
+/*
+ * This posts the interval branching. The obligatory part percentage follows a schedule by width: p for the largest
+ * width down to q for the smallest width, interpolated linearly in between (p == q gives a fixed percentage).
+ */
+void interval(Home home, const IntVarArgs &x, const IntArgs &w, double p, double q) {
     // Check whether arguments make sense
     if (x.size() != w.size())
         throw ArgumentSizeMismatch("interval");
@@ -163,325 +187,2202 @@ void interval(Home home, const IntVarArgs &x, const IntArgs &w, double p) {
     if (home.failed()) return;
     // Create an array of integer views
     ViewArray <IntView> vx(home, x);
-    // Create an array of integers
-    int *wc = static_cast<Space &>(home).alloc<int>(x.size());
-    for (int i = x.size(); i--;)
+    int smallest = Int::Limits::max, largest = 0;
+    for (int i = x.size(); i--;) {
+        smallest = std::min(smallest, w[i]);
+        largest = std::max(largest, w[i]);
+    }
+    // Create arrays of integers, shared by all clones
+    SharedArray<int> wc(x.size()), o(x.size());
+    for (int i = x.size(); i--;) {
         wc[i] = w[i];
+        double t = largest > smallest ? static_cast<double>(w[i] - smallest) / (largest - smallest) : 1.0;
+        o[i] = std::ceil((q + (p - q) * t) * w[i]);
+    }
     // Post the brancher
-    IntervalBrancher::post(home, vx, wc, p);
+    IntervalBrancher::post(home, vx, wc, o);
 }
 
-//
-// square_packing_with_overlap.cpp
-// Created by Kim Hammar & Mallu Goswami on 2017-04-21.
-//
+// This posts the interval branching with fixed percentage p
+void interval(Home home, const IntVarArgs &x, const IntArgs &w, double p) {
+    interval(home, x, w, p, p);
+}
 
-#include <gecode/int.hh>
+/*
+ * Interval brancher over both coordinate arrays: enforces obligatory parts like IntervalBrancher, but chooses the
+ * next square and axis dynamically. Among all coordinates that still have room for an obligatory part the one with
+ * the least slack relative to its side (max - min) / size is chosen, ties go to the larger square and then to x.
+ * Tight coordinates of large squares fail first, and the y-axis no longer waits until every x-interval is done.
+ *
+ * Each square has its own obligatory part size per axis (see interval() for the schedule), and a choice can split
+ * a domain into up to k consecutive intervals at once: every interval but the last is narrow enough that the
+ * square gets its obligatory part, the last interval keeps the remaining values.
+ */
+class IntervalBrancher2D : public Brancher {
+protected:
+    // Views for x-coordinates and y-coordinates
+    ViewArray <IntView> x, y;
+    // Width and height of rectangles
+    SharedArray<int> w, h;
+    // Obligatory part size of each rectangle along x and along y
+    SharedArray<int> ow, oh;
+    // Maximal number of alternatives per choice (at least 2)
+    int k;
+    // Cache of first square with a coordinate to branch on
+    mutable int start;
 
-using namespace Gecode;
-using namespace Gecode::Int;
+    // Description
+    class Description : public Choice {
+    public:
+        // Position of view
+        int pos;
+        // Axis of view, 0 for x and 1 for y
+        int axis;
+        // First value of the first interval
+        int first;
+        // Number of values per interval (but the last)
+        int step;
+
+        Description(const Brancher &b, unsigned int a, int p, int axis, int first, int step)
+                : Choice(b, a), pos(p), axis(axis), first(first), step(step) {}
+
+        // Report size occupied
+        virtual size_t size(void) const {
+            return sizeof(Description);
+        }
+
+        // Archive the choice's information in e
+        virtual void archive(Archive &e) const {
+            Choice::archive(e);
+            e << alternatives() << pos << axis << first << step;
+        }
+    };
+
+    // View of square i on axis a
+    IntView view(int i, int a) const {
+        return a == 0 ? x[i] : y[i];
+    }
+
+    // Number of values per interval of square i along axis a, the interval gives an obligatory part
+    int width(int i, int a) const {
+        return a == 0 ? w[i] - ow[i] + 1 : h[i] - oh[i] + 1;
+    }
+
+    // Whether square i has room for an obligatory part along axis a
+    bool open(int i, int a) const {
+        IntView v = view(i, a);
+        return !v.assigned() && (v.max() - v.min() + 1 > width(i, a));
+    }
+
+    // Slack of square i along axis a relative to its side, the smaller the tighter
+    double slack(int i, int a) const {
+        IntView v = view(i, a);
+        return static_cast<double>(v.max() - v.min()) / (a == 0 ? w[i] : h[i]);
+    }
 
-// The no-overlap propagator
-class NoOverlap : public Propagator {
-protected:
-    // The x-coordinates
-    ViewArray<IntView> x;
-    // The width (array)
-    int *w;
-    // The y-coordinates
-    ViewArray<IntView> y;
-    // The heights (array)
-    int *h;
 public:
-    // Create propagator and initialize
-    NoOverlap(Home home, ViewArray<IntView> &x0, int w0[], ViewArray<IntView> &y0, int h0[]) :
-    //Initialize variables
-            Propagator(home),
-            x(x0),
-            w(w0),
-            y(y0),
-            h(h0) {
-        //Subscription controls the execution of hte propagator
-        x.subscribe(home, *this, PC_INT_BND); //Subscribe to changes in the x-view
-        y.subscribe(home, *this, PC_INT_BND); //Subscribe to changes in the y-view
+    // Construct branching
+    IntervalBrancher2D(Home home, ViewArray <IntView> &x0, const SharedArray<int> &w0,
+                       ViewArray <IntView> &y0, const SharedArray<int> &h0,
+                       const SharedArray<int> &ow0, const SharedArray<int> &oh0, int k0)
+            : Brancher(home), x(x0), y(y0), w(w0), h(h0), ow(ow0), oh(oh0), k(k0), start(0) {
+        //Dispose must also run when the space is deleted, to release the shared arrays
+        home.notice(*this, AP_DISPOSE);
     }
 
-    // Post no-overlap propagator. Post function decides whether propagation is necessary and then creates the propagator
-    // if needed
-    static ExecStatus post(Home home, ViewArray<IntView> &x, int w[], ViewArray<IntView> &y, int h[]) {
-        // Only if there is something to propagate
-        if (x.size() > 1)
-            (void) new(home) NoOverlap(home, x, w, y, h);
-        return ES_OK;
+    // Post branching
+    static void post(Home home, ViewArray <IntView> &x, const SharedArray<int> &w,
+                     ViewArray <IntView> &y, const SharedArray<int> &h,
+                     const SharedArray<int> &ow, const SharedArray<int> &oh, int k) {
+        (void) new(home) IntervalBrancher2D(home, x, w, y, h, ow, oh, k);
     }
 
-    // Copy constructor during cloning
-    NoOverlap(Space &home, bool share, NoOverlap &p)
-            : Propagator(home, share, p) {
-        x.update(home, share, p.x);
-        y.update(home, share, p.y);
-        // Also copy width and height arrays
-        w = home.alloc<int>(x.size());
-        h = home.alloc<int>(y.size());
-        for (int i = x.size(); i--;) {
-            w[i] = p.w[i];
-            h[i] = p.h[i];
-        }
+    // Copy constructor used during cloning of b
+    IntervalBrancher2D(Space &home, bool share, IntervalBrancher2D &b)
+            : Brancher(home, share, b), k(b.k), start(b.start) {
+        x.update(home, share, b.x);
+        y.update(home, share, b.y);
+        w.update(home, share, b.w);
+        h.update(home, share, b.h);
+        ow.update(home, share, b.ow);
+        oh.update(home, share, b.oh);
     }
 
-    // Create copy during cloning
-    virtual Propagator *copy(Space &home, bool share) {
-        return new(home) NoOverlap(home, share, *this);
+    // Copy brancher
+    virtual Actor *copy(Space &home, bool share) {
+        return new(home) IntervalBrancher2D(home, share, *this);
     }
 
-    // Re-schedule function after propagator has been re-enabled
-    virtual void reschedule(Space &home) {
-        x.reschedule(home, *this, PC_INT_BND);
-        y.reschedule(home, *this, PC_INT_BND);
+    // Dispose brancher and return its size
+    virtual size_t dispose(Space &home) {
+        home.ignore(*this, AP_DISPOSE);
+        w.~SharedArray();
+        h.~SharedArray();
+        ow.~SharedArray();
+        oh.~SharedArray();
+        (void) Brancher::dispose(home);
+        return sizeof(*this);
     }
 
-    // Return cost (defined as cheap quadratic complexity)
-    virtual PropCost cost(const Space &, const ModEventDelta &) const {
-        return PropCost::quadratic(PropCost::LO, 2 * x.size());
+    // Check status of brancher, return true if alternatives left
+    virtual bool status(const Space &home) const {
+        /**
+         * Domains only shrink, so a square without room for obligatory parts never gets one again further down.
+         */
+        for (int i = start; i < x.size(); ++i)
+            if (open(i, 0) || open(i, 1)) {
+                start = i;
+                return true;
+            }
+        return false;
     }
 
-    // Perform propagation
-    virtual ExecStatus propagate(Space &home, const ModEventDelta &) {
-        int assigned = 0; //Count how many of the variables are assigned to detect subsumption.
-        bool canOverlap = false;
-        for (int i = 0; i < x.size(); ++i) {
-            bool xCanOverlap = false;
-            bool yCanOverlap = false;
-            if (x[i].assigned() && y[i].assigned())
-                assigned++;
-            for (int j = 0; j < x.size(); ++j) {
-                if (j != i) {
-                    //square i and j overlaps on x-axis so propagate (bounds propagation) that they cant overlap on y-axis
-                    if
-                            (
-                            (x[i].max() <= x[j].min() && x[i].min() + w[i] > x[j].max()) ||
-                            (x[j].max() <= x[i].min() && x[j].min() + w[j] > x[i].max())
-                            )
-                    {
-                        if (y[i].max() <= y[j].min())
-                            GECODE_ME_CHECK(y[j].gq(home, y[i].min() + h[i]));
-
-                        if (y[i].min() + h[i] > y[j].max())
-                            GECODE_ME_CHECK(y[i].gr(home, y[j].min()));
-
-                        if (y[j].max() <= y[i].min())
-                            GECODE_ME_CHECK(y[i].gq(home, y[j].min() + h[j]));
-
-                        if (y[j].min() + h[j] > y[i].max())
-                            GECODE_ME_CHECK(y[j].gr(home, y[i].min()));
-                    }
-                    //square i and j overlaps on y-axis so propagate (bounds propagation) that they cant overlap on x-axis
-                    if
-                            (
-                            (y[i].max() <= y[j].min() && y[i].min() + h[i] > y[j].max()) ||
-                            (y[j].max() <= y[i].min() && y[j].min() + h[j] > y[i].max())
-                            )
-                    {
-                        if (x[i].max() <= x[j].min())
-                            GECODE_ME_CHECK(x[j].gq(home, x[i].min() + w[i]));
-
-                        if (x[i].min() + w[i] > x[j].max())
-                            GECODE_ME_CHECK(x[i].gr(home, x[j].min()));
-
-                        if (x[j].max() <= x[i].min())
-                            GECODE_ME_CHECK(x[i].gq(home, x[j].min() + w[j]));
-
-                        if (x[j].min() + w[j] > x[i].max())
-                            GECODE_ME_CHECK(x[j].gr(home, x[i].min()));
+    // Return choice as description
+    virtual const Choice *choice(Space &home) {
+        int pos = -1, axis = 0;
+        double best = 0.0;
+        for (int i = start; i < x.size(); ++i)
+            for (int a = 0; a < 2; ++a)
+                if (open(i, a)) {
+                    double s = slack(i, a);
+                    //Strictly smaller slack wins, so ties keep the larger square (smaller index) and x before y
+                    if ((pos < 0) || (s < best)) {
+                        pos = i;
+                        axis = a;
+                        best = s;
                     }
-                    if (!xCanOverlap)
-                        xCanOverlap =
-                                //!(Condition where x_i and x_j can never overlap)
-                                //I.e if x_i and x_j can never overlap, xCanOverlap = false
-                                !(
-                                        ((x[i].min() > x[j].max()) || (x[i].max() + w[i] <= x[j].min()))
-                                        &&
-                                        ((x[j].min() > x[i].max()) || (x[j].max() + w[j] <= x[i].min()))
-
-                                );
-
-                    if (!yCanOverlap)
-                        yCanOverlap =
-                                //!(Condition where y_i and y_j can never overlap)
-                                //I.e if y_i and y_j can never overlap, yCanOverlap = false
-                                !(
-                                        ((y[i].min() > y[j].max()) || (y[i].max() + h[i] <= y[j].min()))
-                                        &&
-                                        ((y[j].min() > y[i].max()) || (y[j].max() + h[j] <= y[i].min()))
-
-                                );
                 }
-            }
-            if (!canOverlap)//If no previous squares could overlap, update the bool by checking if these 2 squares can overlap.
-                canOverlap = xCanOverlap && yCanOverlap;
-        }
-        if (!canOverlap)
-            return home.ES_SUBSUMED(*this); //No variable domains can overlap no matter assignment, no more propagation necessary
+        IntView v = view(pos, axis);
+        int step = width(pos, axis);
+        //Intervals of step values while they fit, the last alternative takes the rest of the domain
+        int fit = (v.max() - v.min() + 1 + step - 1) / step;
+        unsigned int alternatives = std::min(k, fit);
+        return new Description(*this, alternatives, pos, axis, v.min(), step);
+    }
 
-        if (assigned == y.size())
-            return home.ES_SUBSUMED(*this); //All variables assigned, no more propagation necessary.
-        return ES_NOFIX; //Propagator is not idempotent, max and min bounds might change and affect propagation.
+    // Construct choice from archive e, in the order written by Description::archive
+    virtual const Choice *choice(const Space &, Archive &e) {
+        unsigned int alternatives;
+        int pos, axis, first, step;
+        e >> alternatives >> pos >> axis >> first >> step;
+        return new Description(*this, alternatives, pos, axis, first, step);
     }
 
-    // Dispose propagator and return its size (dispose works as garbage collection, must cancel subscription first).
-    virtual size_t dispose(Space &home) {
-        x.cancel(home, *this, PC_INT_BND);
-        y.cancel(home, *this, PC_INT_BND);
-        (void) Propagator::dispose(home);
-        return sizeof(*this);
+    // Perform commit for choice c and alternative a
+    virtual ExecStatus commit(Space &home, const Choice &c, unsigned int a) {
+        const Description &d = static_cast<const Description &>(c);
+        IntView v = view(d.pos, d.axis);
+        /**
+         * Alternative a is [first + a * step, first + (a + 1) * step - 1], the last one is open to the right.
+         * Consecutive intervals keep the alternatives disjoint.
+         */
+        GECODE_ME_CHECK(v.gq(home, d.first + static_cast<int>(a) * d.step));
+        if (a + 1 < d.alternatives())
+            GECODE_ME_CHECK(v.lq(home, d.first + static_cast<int>(a + 1) * d.step - 1));
+        return ES_OK;
+    }
+
+    /**
+     * Return no-good literal for alternative a. Alternatives are explored left to right, so the upper bound of
+     * alternative a also covers the exhausted intervals before it, and the last alternative is its lower bound.
+     */
+    virtual NGL *ngl(Space &home, const Choice &c, unsigned int a) const {
+        const Description &d = static_cast<const Description &>(c);
+        IntView v = view(d.pos, d.axis);
+        if (a + 1 < d.alternatives())
+            return new(home) Int::Branch::LqNGL<IntView>(home, v, d.first + static_cast<int>(a + 1) * d.step - 1);
+        else
+            return new(home) Int::Branch::GqNGL<IntView>(home, v, d.first + static_cast<int>(a) * d.step);
+    }
+
+    // Print some information on stream o (used by Gist, from Gecode 4.0.1 on)
+    virtual void print(const Space &home, const Choice &c, unsigned int b,
+                       std::ostream &o) const {
+        const Description &d = static_cast<const Description &>(c);
+        o << (d.axis == 0 ? "x[" : "y[") << d.pos << "] >= " << d.first + static_cast<int>(b) * d.step;
+        if (b + 1 < d.alternatives())
+            o << " and <= " << d.first + static_cast<int>(b + 1) * d.step - 1;
     }
 };
 
 /*
- * Post the constraint that the rectangles defined by the coordinates
- * x and y and width w and height h do not overlap.
- *
- * This is the function that you will call from your model. The best
- * is to paste the entire file into your model.
- *
- * Post function checks whether arguments are correct and whether the the space is failed or not before posting the
- * propagator.
+ * This posts the interval branching over both coordinate arrays with at most k alternatives per choice.
+ * The obligatory part percentage follows a schedule by side length: p for the largest side down to q for the
+ * smallest side, interpolated linearly in between (p == q gives a fixed percentage).
  */
-void nooverlap(Space &home,
-               const IntVarArgs &x, const IntArgs &w,
-               const IntVarArgs &y, const IntArgs &h) {
-    // Check whether the arguments make sense
-    if ((x.size() != y.size()) || (x.size() != w.size()) ||
-        (y.size() != h.size()))
-        throw ArgumentSizeMismatch("nooverlap");
-    // Never post a propagator in a failed space
+void interval(Home home, const IntVarArgs &x, const IntArgs &w, const IntVarArgs &y, const IntArgs &h,
+              double p, double q, int k) {
+    // Check whether arguments make sense
+    if ((x.size() != w.size()) || (y.size() != h.size()) || (x.size() != y.size()))
+        throw ArgumentSizeMismatch("interval");
+    if (k < 2)
+        throw OutOfLimits("interval");
+    // Never post a branching in a failed space
     if (home.failed()) return;
-    // Set up array of views for the coordinates
-    ViewArray<IntView> vx(home, x);
-    ViewArray<IntView> vy(home, y);
-    // Set up arrays (allocated in home) for width and height and initialize
-    int *wc = static_cast<Space &>(home).alloc<int>(x.size());
-    int *hc = static_cast<Space &>(home).alloc<int>(y.size());
+    ViewArray <IntView> vx(home, x), vy(home, y);
+    int smallest = Int::Limits::max, largest = 0;
+    for (int i = x.size(); i--;) {
+        smallest = std::min(smallest, std::min(w[i], h[i]));
+        largest = std::max(largest, std::max(w[i], h[i]));
+    }
+    // Create arrays of integers, shared by all clones
+    SharedArray<int> wc(x.size()), hc(y.size()), ow(x.size()), oh(y.size());
     for (int i = x.size(); i--;) {
         wc[i] = w[i];
         hc[i] = h[i];
+        double tw = largest > smallest ? static_cast<double>(w[i] - smallest) / (largest - smallest) : 1.0;
+        double th = largest > smallest ? static_cast<double>(h[i] - smallest) / (largest - smallest) : 1.0;
+        ow[i] = std::ceil((q + (p - q) * tw) * w[i]);
+        oh[i] = std::ceil((q + (p - q) * th) * h[i]);
     }
-    // If posting failed, fail space
-    if (NoOverlap::post(home, vx, wc, vy, hc) != ES_OK)
-        home.fail();
+    IntervalBrancher2D::post(home, vx, wc, vy, hc, ow, oh, k);
 }
 
-#include <gecode/driver.hh>
-#include <gecode/int.hh>
-#include <gecode/minimodel.hh>
-
-using namespace Gecode;
+// This posts the binary interval branching over both coordinate arrays with fixed percentage p
+void interval(Home home, const IntVarArgs &x, const IntArgs &w, const IntVarArgs &y, const IntArgs &h, double p) {
+    interval(home, x, w, y, h, p, p, 2);
+}
 
-/**
- * ObligatoryPartSizeOptions for choosing how large the obligatory part in interval-branching should be in percentage.
+/*
+ * Bounded table of partial packings known to fail, used by CornerBrancher.
+ *
+ * With corner-point placement the squares placed by the brancher and the waste cells form a skyline: every column
+ * is covered from the bottom up to some height. Squares fixed by propagation or by earlier branchings can lie above
+ * it. The remaining problem is therefore fully described by the enclosing size, the skyline, the placed squares that
+ * are not below the skyline, and the unplaced squares with their whole domains. Two placement orders that reach the
+ * same description have the same completions, so a description whose subtree was exhausted without a solution can
+ * be pruned when it is reached again.
+ *
+ * A subtree is known to be exhausted by the order of a sequential DFS: when a choice is made at corner depth d, every
+ * pending node at depth >= d is not an ancestor and has been finished. If no solution was found since the node was
+ * reached, it failed. This only holds for one sequential DFS without restarts that reports every solution with
+ * solution(), see solveWithMemo(). The memo is not synchronised: solveWithMemo() owns it and is the only driver that
+ * hands it to SquarePacking, every other model gets NULL. With capacity 0 it does nothing, so the presolve probes of
+ * solveWithMemo() may share it before it is enabled.
+ * The table is direct-mapped by hash, a new failure replaces the entry in its slot.
  */
-class ObligatoryPartSizeOptions : public Options {
-private:
-    Driver::DoubleOption _obligatory;
-    Driver::UnsignedIntOption _dimension;
-public :
-    ObligatoryPartSizeOptions(const char *e) :
-            Options(e),
-            _obligatory("-obligatory", "Obligatory part size in percentage 0.0-1.0", 0.35),
-            _dimension("-dimension", "Square dimension integer > 1", 2){
-        add(_obligatory);
-        add(_dimension);
+class SkylineMemo {
+protected:
+    // Stored failed descriptions, an empty key marks a free slot
+    std::vector<std::vector<int> > table;
+    // Nodes reached but not known to be finished: corner depth, description and solutions found before
+    struct Pending {
+        int depth;
+        std::vector<int> key;
+        unsigned long int solutions;
+    };
+    std::vector<Pending> pending;
+    // Number of solutions found so far
+    unsigned long int solutions;
+    // Statistics
+    unsigned long int entries, lookups, hits;
+
+    // Slot of key
+    size_t slot(const std::vector<int> &key) const {
+        unsigned int hash = 2166136261u;
+        for (unsigned int i = 0; i < key.size(); ++i)
+            hash = (hash ^ static_cast<unsigned int>(key[i])) * 16777619u;
+        return hash % table.size();
     }
 
-    void parse(int &argc, char *argv[]) {
-        Options::parse(argc, argv);
+public:
+    SkylineMemo(void) : solutions(0), entries(0), lookups(0), hits(0) {}
+
+    // Allocate room for capacity entries, 0 disables the memo
+    void resize(unsigned int capacity) {
+        table.assign(capacity, std::vector<int>());
     }
 
-    double obligatory(void) const {
-        return _obligatory.value();
+    unsigned int capacity(void) const {
+        return table.size();
     }
 
-    int dimension(void) const {
-        return _dimension.value();
+    // A solution has been found
+    void solution(void) {
+        solutions++;
     }
-};
 
-class SquarePacking : public Script {
+    // Record the pending nodes at depth >= d as finished, the ones without solutions as failed
+    void finish(int depth) {
+        if (table.empty())
+            return;
+        while (!pending.empty() && (pending.back().depth >= depth)) {
+            Pending &p = pending.back();
+            if (p.solutions == solutions) {
+                std::vector<int> &e = table[slot(p.key)];
+                if (e.empty())
+                    entries++;
+                e.swap(p.key);
+            }
+            pending.pop_back();
+        }
+    }
 
-public:
-    const int n;
-    const double p;
-    IntVar s;
-    IntVarArray xCoords, yCoords;
+    // Whether key is known to fail, otherwise key becomes pending at the given depth
+    bool failed(int depth, const std::vector<int> &key) {
+        if (table.empty())
+            return false;
+        lookups++;
+        if (table[slot(key)] == key) {
+            hits++;
+            return true;
+        }
+        Pending p;
+        p.depth = depth;
+        p.key = key;
+        p.solutions = solutions;
+        pending.push_back(p);
+        return false;
+    }
 
-    SquarePacking(const ObligatoryPartSizeOptions &opt) :
-            Script(opt),
-            n(opt.dimension()),
-            p(opt.obligatory()),
-            s(*this, nSquaresArea(), nSquaresStacked(n)), //Problem decomposition, constraint min and max of s, s will be the first branching to enumerate subproblems.
-            xCoords(*this, n - 1, 0, nSquaresStacked(n)),//min coordinate = (0,0) max = (s,s). exclude 1x1 square
-            yCoords(*this, n - 1, 0, nSquaresStacked(n))//min coordinate = (0,0) max = (s,s). exclude 1x1 square
-    {
+    // Print statistics
+    void print(std::ostream &os) const {
+        os << "\tmemo entries: " << entries << " (capacity " << table.size() << ")" << std::endl
+           << "\tmemo lookups: " << lookups << ", hits: " << hits << " ("
+           << (lookups > 0 ? (100.0 * hits) / lookups : 0.0) << "%)" << std::endl;
+    }
+};
 
-        /**
-         * Constraint on the origin coordinate of the squares.
-         * Square must be within enclosing square (s x s) (>= 0) and must not
-         * exceed x or y axis (<= s-size(i).
-         */
-        for (int i = 0; i < n - 1; ++i) {
-            rel(*this, xCoords[i] >= 0);
-            rel(*this, xCoords[i] <= s - size(i));
-            rel(*this, yCoords[i] >= 0);
-            rel(*this, yCoords[i] <= s - size(i));
-        }
+/*
+ * Corner-point brancher: places squares at the bottom-left corner of the free area instead of assigning x and y
+ * independently. Once the enclosing size s is assigned, the lowest (then leftmost) cell of the s x s square that is
+ * neither covered by a placed square nor declared waste is chosen. Every cell below it and left of it in its row is
+ * taken, so a square covering the cell must have its origin exactly there. The alternatives place each unplaced
+ * square that fits at the cell (largest first), the last alternative declares the cell waste so that no square may
+ * cover it. No holes are left that only a later, differently ordered placement could fill.
+ */
+class CornerBrancher : public Brancher {
+protected:
+    // Views for x-coordinates and y-coordinates
+    ViewArray <IntView> x, y;
+    // Width and height of rectangles
+    SharedArray<int> w, h;
+    // Size of the enclosing square, assigned before this brancher runs (see corner())
+    IntView s;
+    // Cells declared waste on the way to this space (bit per cell of the s x s square, NULL while there is none)
+    unsigned int *waste;
+    // Number of words of waste
+    int words;
+    // Number of corner commits on the way to this space
+    int depth;
+    // Memo of failed partial packings, NULL or of capacity 0 if disabled
+    SkylineMemo *memo;
 
-        /**
-         * Apply constraints on coordinates that squares should not overlap (disjoint)
-         */
-        IntArgs w(n - 1);
-        IntArgs h(n - 1);
+    // Description
+    class Description : public Choice {
+    public:
+        // Chosen cell, -1 if the node fails (unplaced squares but no free cell, or a known failed packing)
+        int cx, cy;
+        // Squares placed at the cell by the alternatives before the last (waste) alternative
+        int *squares;
+        int m;
 
-        for (int i = 0; i < n - 1; i++) {
-            w[i] = size(i);
-            h[i] = size(i);
-        }
-        nooverlap(*this, xCoords, w, yCoords, h);
+        Description(const Brancher &b, int cx, int cy, int *squares, int m)
+                : Choice(b, m + 1), cx(cx), cy(cy), squares(squares), m(m) {}
 
-        /**
-         * Apply (cumulative) constraints of max sum(squareHeight) on columns and max sum(squareWidth) on rows.
-         * Redundant constraints to increase propagation, the non-overlapping coordinates implies this constraint.
-         * This redundant constraint have very big impact on performance.
-         */
-        for (int i = 0; i < s.max(); ++i) {
-            BoolVarArgs colOverlap(*this, n - 1, 0, 1);
-            BoolVarArgs rowOverlap(*this, n - 1, 0, 1);
-            for (int j = 0; j < n - 1; ++j) {
-                dom(*this, xCoords[j], i - size(j) + 1, i, colOverlap[j]);//x <= colIndex < x means overlap
-                dom(*this, yCoords[j], i - size(j) + 1, i, rowOverlap[j]);//y <= rowIndex < y means overlap
-            }
-            /**
-             * sum of the sizes of the squares occupying space at column x must be less than or equal to s.
-             * sum of the sizes of the squares occupying space at row y must be less than or equal to s.
-             */
-            rel(*this, sum(IntArgs::create(n - 1, n, -1), colOverlap) <= s, opt.ipl());
-            rel(*this, sum(IntArgs::create(n - 1, n, -1), rowOverlap) <= s, opt.ipl());
+        virtual ~Description(void) {
+            heap.free<int>(squares, m);
         }
 
-        /**
-         * Symmetry breaking. Restrict placement of the largest inside-square (n x n)
-         */
-        rel(*this, xCoords[0] <= 1 + (s - n) / 2);
-        rel(*this, yCoords[0] <= xCoords[0]);
+        // Report size occupied
+        virtual size_t size(void) const {
+            return sizeof(Description) + m * sizeof(int);
+        }
 
-        /**
-         * Empty-strip dominance
-         */
-        int gapLim = n - 1 > 45 ? 45 : n - 1;
-        for (int i = 2; i < gapLim; ++i) {
-            rel(*this, xCoords[i] != gap_generic(i));
-            rel(*this, yCoords[i] != gap_generic(i));
-            if (i < 4)
-                rel(*this, yCoords[i] != gap_specific(i));
+        // Archive the choice's information in e
+        virtual void archive(Archive &e) const {
+            Choice::archive(e);
+            e << cx << cy << m;
+            for (int i = 0; i < m; ++i)
+                e << squares[i];
+        }
+    };
+
+    // Whether square i has been placed
+    bool placed(int i) const {
+        return x[i].assigned() && y[i].assigned();
+    }
+
+    // Whether cell (cx, cy) is declared waste
+    bool wasted(int cx, int cy) const {
+        int c = cy * s.val() + cx;
+        return (waste != NULL) && ((waste[c / 32] >> (c % 32)) & 1u);
+    }
+
+    // Whether placed square i covers a cell declared waste
+    bool coversWaste(int i) const {
+        for (int b = y[i].val(); (waste != NULL) && (b < y[i].val() + h[i]); ++b)
+            for (int a = x[i].val(); a < x[i].val() + w[i]; ++a)
+                if (wasted(a, b))
+                    return true;
+        return false;
+    }
+
+public:
+    // Construct branching
+    CornerBrancher(Home home, ViewArray <IntView> &x0, const SharedArray<int> &w0,
+                   ViewArray <IntView> &y0, const SharedArray<int> &h0, IntView s0, SkylineMemo *memo0)
+            : Brancher(home), x(x0), y(y0), w(w0), h(h0), s(s0), waste(NULL), words(0), depth(0), memo(memo0) {
+        //Dispose must also run when the space is deleted, to release the shared arrays
+        home.notice(*this, AP_DISPOSE);
+    }
+
+    // Post branching
+    static void post(Home home, ViewArray <IntView> &x, const SharedArray<int> &w,
+                     ViewArray <IntView> &y, const SharedArray<int> &h, IntView s, SkylineMemo *memo) {
+        (void) new(home) CornerBrancher(home, x, w, y, h, s, memo);
+    }
+
+    // Copy constructor used during cloning of b
+    CornerBrancher(Space &home, bool share, CornerBrancher &b)
+            : Brancher(home, share, b), waste(NULL), words(b.words), depth(b.depth), memo(b.memo) {
+        x.update(home, share, b.x);
+        y.update(home, share, b.y);
+        w.update(home, share, b.w);
+        h.update(home, share, b.h);
+        s.update(home, share, b.s);
+        if (b.waste != NULL) {
+            waste = home.alloc<unsigned int>(words);
+            for (int k = 0; k < words; ++k)
+                waste[k] = b.waste[k];
+        }
+    }
+
+    // Copy brancher
+    virtual Actor *copy(Space &home, bool share) {
+        return new(home) CornerBrancher(home, share, *this);
+    }
+
+    // Dispose brancher and return its size
+    virtual size_t dispose(Space &home) {
+        home.ignore(*this, AP_DISPOSE);
+        if (waste != NULL)
+            home.free<unsigned int>(waste, words);
+        w.~SharedArray();
+        h.~SharedArray();
+        (void) Brancher::dispose(home);
+        return sizeof(*this);
+    }
+
+    // Check status of brancher, return true if some square is not placed yet or a placed one covers waste
+    virtual bool status(const Space &home) const {
+        for (int i = 0; i < x.size(); ++i)
+            if (!placed(i))
+                return true;
+        //Squares placed by propagation over a waste cell, choice() fails the node
+        for (int i = 0; i < x.size(); ++i)
+            if (coversWaste(i))
+                return true;
+        //Everything placed after propagation: a solution (reported to the memo by solveWithMemo())
+        return false;
+    }
+
+    // Return choice as description
+    virtual const Choice *choice(Space &home) {
+        const int l = s.val();
+        Region r(home);
+        char *covered = r.alloc<char>(l * l);
+        for (int c = 0; c < l * l; ++c)
+            covered[c] = 0;
+        for (int i = 0; i < x.size(); ++i)
+            if (placed(i)) {
+                if (coversWaste(i))
+                    return new Description(*this, -1, -1, heap.alloc<int>(0), 0);
+                for (int b = y[i].val(); b < y[i].val() + h[i]; ++b)
+                    for (int a = x[i].val(); a < x[i].val() + w[i]; ++a)
+                        covered[b * l + a] = 1;
+            }
+        if ((memo != NULL) && (memo->capacity() > 0)) {
+            //Skyline, then per square: 0 if placed below the skyline, 1 and its origin if placed elsewhere,
+            //2 and the ranges of both domains (each preceded by their number) if unplaced
+            std::vector<int> key(1, l);
+            int *top = r.alloc<int>(l);
+            for (int a = 0; a < l; ++a) {
+                top[a] = 0;
+                while ((top[a] < l) && (covered[top[a] * l + a] || wasted(a, top[a])))
+                    top[a]++;
+                key.push_back(top[a]);
+            }
+            for (int i = 0; i < x.size(); ++i)
+                if (placed(i)) {
+                    bool below = true;
+                    for (int a = x[i].val(); a < x[i].val() + w[i]; ++a)
+                        below = below && (y[i].val() + h[i] <= top[a]);
+                    if (below) {
+                        key.push_back(0);
+                    } else {
+                        int origin[] = {1, x[i].val(), y[i].val()};
+                        key.insert(key.end(), origin, origin + 3);
+                    }
+                } else {
+                    key.push_back(2);
+                    for (int axis = 0; axis < 2; ++axis) {
+                        size_t count = key.size();
+                        key.push_back(0);
+                        for (ViewRanges<IntView> v(axis == 0 ? x[i] : y[i]); v(); ++v) {
+                            key.push_back(v.min());
+                            key.push_back(v.max());
+                            key[count]++;
+                        }
+                    }
+                }
+            memo->finish(depth);
+            if (memo->failed(depth, key))
+                return new Description(*this, -1, -1, heap.alloc<int>(0), 0);
+        }
+        //Lowest, then leftmost, cell that is neither covered nor waste
+        int cx = -1, cy = -1;
+        for (int c = 0; (c < l * l) && (cx < 0); ++c)
+            if (!covered[c] && !wasted(c % l, c / l)) {
+                cx = c % l;
+                cy = c / l;
+            }
+        int *squares = heap.alloc<int>(x.size());
+        int m = 0;
+        if (cx >= 0)
+            for (int i = 0; i < x.size(); ++i)
+                if (!placed(i) && x[i].in(cx) && y[i].in(cy) && (cx + w[i] <= l) && (cy + h[i] <= l))
+                    squares[m++] = i;
+        squares = heap.realloc<int>(squares, x.size(), m);
+        return new Description(*this, cx, cy, squares, m);
+    }
+
+    // Construct choice from archive e, in the order written by Description::archive
+    virtual const Choice *choice(const Space &, Archive &e) {
+        int cx, cy, m;
+        e >> cx >> cy >> m;
+        int *squares = heap.alloc<int>(m);
+        for (int i = 0; i < m; ++i)
+            e >> squares[i];
+        return new Description(*this, cx, cy, squares, m);
+    }
+
+    // Perform commit for choice c and alternative a
+    virtual ExecStatus commit(Space &home, const Choice &c, unsigned int a) {
+        const Description &d = static_cast<const Description &>(c);
+        //Unplaced squares but every cell is taken
+        if (d.cx < 0)
+            return ES_FAILED;
+        depth++;
+        if (a < static_cast<unsigned int>(d.m)) {
+            int i = d.squares[a];
+            GECODE_ME_CHECK(x[i].eq(home, d.cx));
+            GECODE_ME_CHECK(y[i].eq(home, d.cy));
+            return ES_OK;
+        }
+        /**
+         * Waste alternative: remember the cell. Every cell in the rows below and left of it in its row is taken, so
+         * a square can only cover the cell with its origin exactly there. That origin is pruned directly where one
+         * coordinate is already fixed, placements found later by propagation are failed by status() and choice().
+         */
+        const int l = s.val();
+        if (waste == NULL) {
+            words = (l * l + 31) / 32;
+            waste = home.alloc<unsigned int>(words);
+            for (int k = 0; k < words; ++k)
+                waste[k] = 0;
+        }
+        int cell = d.cy * l + d.cx;
+        waste[cell / 32] |= 1u << (cell % 32);
+        for (int i = 0; i < x.size(); ++i)
+            if (!placed(i)) {
+                if (y[i].assigned() && (y[i].val() == d.cy))
+                    GECODE_ME_CHECK(x[i].nq(home, d.cx));
+                else if (x[i].assigned() && (x[i].val() == d.cx))
+                    GECODE_ME_CHECK(y[i].nq(home, d.cy));
+            }
+        return ES_OK;
+    }
+
+    // Print some information on stream o (used by Gist, from Gecode 4.0.1 on)
+    virtual void print(const Space &home, const Choice &c, unsigned int b,
+                       std::ostream &o) const {
+        const Description &d = static_cast<const Description &>(c);
+        if (d.cx < 0)
+            o << "fail";
+        else if (b < static_cast<unsigned int>(d.m))
+            o << "square[" << d.squares[b] << "] at (" << d.cx << "," << d.cy << ")";
+        else
+            o << "(" << d.cx << "," << d.cy << ") is waste";
+    }
+};
+
+/*
+ * This posts the corner-point branching. The brancher needs s assigned, so s is branched on first (smallest value
+ * first) unless it is assigned already; a branching on s posted earlier makes that one a no-op.
+ * Failed partial packings are recorded in and pruned by memo unless it is NULL.
+ */
+void corner(Home home, const IntVarArgs &x, const IntArgs &w, const IntVarArgs &y, const IntArgs &h, IntVar s,
+            SkylineMemo *memo = NULL) {
+    // Check whether arguments make sense
+    if ((x.size() != w.size()) || (y.size() != h.size()) || (x.size() != y.size()))
+        throw ArgumentSizeMismatch("corner");
+    // Never post a branching in a failed space
+    if (home.failed()) return;
+    ViewArray <IntView> vx(home, x), vy(home, y);
+    // Create arrays of integers, shared by all clones
+    SharedArray<int> wc(x.size()), hc(y.size());
+    for (int i = x.size(); i--;) {
+        wc[i] = w[i];
+        hc[i] = h[i];
+    }
+    if (!s.assigned())
+        branch(home, s, INT_VAL_MIN());
+    CornerBrancher::post(home, vx, wc, vy, hc, IntView(s), memo);
+}
+
+//
+// square_packing_with_overlap.cpp
+// Created by Kim Hammar & Mallu Goswami on 2017-04-21.
+//
+
+#include <gecode/int.hh>
+
+#include <algorithm>
+
+#include "nooverlap_kernel.hpp"
+#include "square_gaps.hpp"
+
+using namespace Gecode;
+using namespace Gecode::Int;
+
+// Perform modification event me and remember in modified whether it changed the view
+inline ExecStatus noOverlapCheck(ModEvent me, bool &modified) {
+    if (me_failed(me))
+        return ES_FAILED;
+    if (me_modified(me))
+        modified = true;
+    return ES_OK;
+}
+
+/**
+ * Apply the pairwise no-overlap rules for the squares i and j with coordinates x, y and sizes w, h: if they must
+ * overlap on one axis, push them apart on the other axis. Sets modified if a bound changed.
+ * Shared by NoOverlap and NoOverlapIncremental.
+ */
+inline ExecStatus noOverlapPair(Space &home, ViewArray<IntView> &x, const SharedArray<int> &w,
+                                ViewArray<IntView> &y, const SharedArray<int> &h, int i, int j, bool &modified) {
+    //square i and j overlaps on x-axis so propagate (bounds propagation) that they cant overlap on y-axis
+    if ((x[i].max() <= x[j].min() && x[i].min() + w[i] > x[j].max()) ||
+        (x[j].max() <= x[i].min() && x[j].min() + w[j] > x[i].max())) {
+        if (y[i].max() <= y[j].min())
+            GECODE_ES_CHECK(noOverlapCheck(y[j].gq(home, y[i].min() + h[i]), modified));
+        if (y[i].min() + h[i] > y[j].max())
+            GECODE_ES_CHECK(noOverlapCheck(y[i].gr(home, y[j].min()), modified));
+        if (y[j].max() <= y[i].min())
+            GECODE_ES_CHECK(noOverlapCheck(y[i].gq(home, y[j].min() + h[j]), modified));
+        if (y[j].min() + h[j] > y[i].max())
+            GECODE_ES_CHECK(noOverlapCheck(y[j].gr(home, y[i].min()), modified));
+    }
+    //square i and j overlaps on y-axis so propagate (bounds propagation) that they cant overlap on x-axis
+    if ((y[i].max() <= y[j].min() && y[i].min() + h[i] > y[j].max()) ||
+        (y[j].max() <= y[i].min() && y[j].min() + h[j] > y[i].max())) {
+        if (x[i].max() <= x[j].min())
+            GECODE_ES_CHECK(noOverlapCheck(x[j].gq(home, x[i].min() + w[i]), modified));
+        if (x[i].min() + w[i] > x[j].max())
+            GECODE_ES_CHECK(noOverlapCheck(x[i].gr(home, x[j].min()), modified));
+        if (x[j].max() <= x[i].min())
+            GECODE_ES_CHECK(noOverlapCheck(x[i].gq(home, x[j].min() + w[j]), modified));
+        if (x[j].min() + w[j] > x[i].max())
+            GECODE_ES_CHECK(noOverlapCheck(x[j].gr(home, x[i].min()), modified));
+    }
+    return ES_OK;
+}
+
+// The no-overlap propagator
+class NoOverlap : public Propagator {
+protected:
+    // The x-coordinates
+    ViewArray<IntView> x;
+    // The width (array)
+    SharedArray<int> w;
+    // The y-coordinates
+    ViewArray<IntView> y;
+    // The heights (array)
+    SharedArray<int> h;
+    // Active pairs, bit j of row i (j > i) is set while squares i and j can still overlap. Copied with the space,
+    // so a pair proven disjoint stays removed for the whole subtree. Rows use the word layout of NoOverlapKernel.
+    unsigned int *active;
+    // Number of words per row of active
+    int words;
+    // Number of active pairs, no active pair left means subsumption
+    int nActive;
+
+    /**
+     * Squares i and j can never overlap if the envelopes [min, max + size) of their coordinates are disjoint on
+     * the x-axis or on the y-axis. Bounds only shrink, so this stays true further down the search tree.
+     */
+    bool disjoint(int i, int j) const {
+        return (x[i].max() + w[i] <= x[j].min()) || (x[j].max() + w[j] <= x[i].min()) ||
+               (y[i].max() + h[i] <= y[j].min()) || (y[j].max() + h[j] <= y[i].min());
+    }
+
+    // Copy the current bounds of square i into the kernel arrays
+    void bounds(NoOverlapKernel::Bounds &b, int i) const {
+        b.xmin[i] = x[i].min();
+        b.xmax[i] = x[i].max();
+        b.ymin[i] = y[i].min();
+        b.ymax[i] = y[i].max();
+    }
+
+public:
+    // Create propagator and initialize
+    NoOverlap(Home home, ViewArray<IntView> &x0, const SharedArray<int> &w0, ViewArray<IntView> &y0, const SharedArray<int> &h0) :
+    //Initialize variables
+            Propagator(home),
+            x(x0),
+            w(w0),
+            y(y0),
+            h(h0),
+            words(NoOverlapKernel::words(x0.size())),
+            nActive(0) {
+        //Initially every pair i < j is active
+        active = static_cast<Space &>(home).alloc<unsigned int>(x.size() * words);
+        for (int i = 0; i < x.size(); ++i)
+            for (int k = 0; k < words; ++k) {
+                unsigned int row = 0;
+                for (int b = 0; b < NoOverlapKernel::block; ++b) {
+                    int j = k * NoOverlapKernel::block + b;
+                    if ((j > i) && (j < x.size())) {
+                        row |= 1u << b;
+                        nActive++;
+                    }
+                }
+                active[i * words + k] = row;
+            }
+        //Subscription controls the execution of hte propagator
+        x.subscribe(home, *this, PC_INT_BND); //Subscribe to changes in the x-view
+        y.subscribe(home, *this, PC_INT_BND); //Subscribe to changes in the y-view
+        //Dispose must also run when the space is deleted, to release the shared width and height arrays
+        home.notice(*this, AP_DISPOSE);
+    }
+
+    // Post no-overlap propagator. Post function decides whether propagation is necessary and then creates the propagator
+    // if needed
+    static ExecStatus post(Home home, ViewArray<IntView> &x, const SharedArray<int> &w, ViewArray<IntView> &y, const SharedArray<int> &h) {
+        // Only if there is something to propagate
+        if (x.size() > 1)
+            (void) new(home) NoOverlap(home, x, w, y, h);
+        return ES_OK;
+    }
+
+    // Copy constructor during cloning
+    NoOverlap(Space &home, bool share, NoOverlap &p)
+            : Propagator(home, share, p), words(p.words), nActive(p.nActive) {
+        x.update(home, share, p.x);
+        y.update(home, share, p.y);
+        // Width and height never change, clones share them
+        w.update(home, share, p.w);
+        h.update(home, share, p.h);
+        // And the active pairs
+        active = home.alloc<unsigned int>(x.size() * words);
+        for (int k = x.size() * words; k--;)
+            active[k] = p.active[k];
+    }
+
+    // Create copy during cloning
+    virtual Propagator *copy(Space &home, bool share) {
+        return new(home) NoOverlap(home, share, *this);
+    }
+
+    // Re-schedule function after propagator has been re-enabled
+    virtual void reschedule(Space &home) {
+        x.reschedule(home, *this, PC_INT_BND);
+        y.reschedule(home, *this, PC_INT_BND);
+    }
+
+    // Return cost (defined as cheap quadratic complexity)
+    virtual PropCost cost(const Space &, const ModEventDelta &) const {
+        return PropCost::quadratic(PropCost::LO, 2 * x.size());
+    }
+
+protected:
+    /**
+     * One pair at a time over the active pairs until no bound changes anymore.
+     */
+    ExecStatus pairs(Space &home) {
+        bool modified;
+        do {
+            modified = false;
+            for (int i = 0; i < x.size(); ++i) {
+                unsigned int *row = &active[i * words];
+                for (int k = i / NoOverlapKernel::block; k < words; ++k) {
+                    if (row[k] == 0)
+                        continue;
+                    for (int b = 0; b < NoOverlapKernel::block; ++b) {
+                        if (!(row[k] & (1u << b)))
+                            continue;
+                        int j = k * NoOverlapKernel::block + b;
+                        GECODE_ES_CHECK(noOverlapPair(home, x, w, y, h, i, j, modified));
+                        if (disjoint(i, j)) {
+                            row[k] &= ~(1u << b);
+                            nActive--;
+                        }
+                    }
+                }
+            }
+        } while (modified);
+        return ES_OK;
+    }
+
+    /**
+     * Same fixpoint with NoOverlapKernel. The bounds are copied into contiguous arrays once per round, and the
+     * kernel tests one square against a whole word of partners at once. Only pairs that must overlap on some axis
+     * reach the (scalar) rules. Bounds changed by the rules are written back, masks computed before a change are
+     * weaker but still sound and the change causes another round anyway.
+     */
+    ExecStatus kernel(Space &home) {
+        int n = x.size();
+        int padded = NoOverlapKernel::padded(n);
+        Region r(home);
+        NoOverlapKernel::Bounds b;
+        b.xmin = r.alloc<int>(padded);
+        b.xmax = r.alloc<int>(padded);
+        b.w = r.alloc<int>(padded);
+        b.ymin = r.alloc<int>(padded);
+        b.ymax = r.alloc<int>(padded);
+        b.h = r.alloc<int>(padded);
+        for (int i = padded; i--;) {
+            b.xmin[i] = b.xmax[i] = b.ymin[i] = b.ymax[i] = 0;
+            b.w[i] = (i < n) ? w[i] : 0;
+            b.h[i] = (i < n) ? h[i] : 0;
+        }
+
+        bool modified;
+        do {
+            modified = false;
+            for (int i = 0; i < n; ++i)
+                bounds(b, i);
+            for (int i = 0; i < n; ++i) {
+                unsigned int *row = &active[i * words];
+                for (int k = i / NoOverlapKernel::block; k < words; ++k) {
+                    if (row[k] == 0)
+                        continue;
+                    NoOverlapKernel::Masks m = NoOverlapKernel::word(b, i, k);
+                    unsigned int forced = row[k] & (m.xForced | m.yForced);
+                    for (int bit = 0; forced != 0; ++bit, forced >>= 1) {
+                        if (!(forced & 1u))
+                            continue;
+                        int j = k * NoOverlapKernel::block + bit;
+                        GECODE_ES_CHECK(noOverlapPair(home, x, w, y, h, i, j, modified));
+                        bounds(b, i);
+                        bounds(b, j);
+                    }
+                    //Pairs whose envelopes were disjoint before the rules are disjoint for good
+                    unsigned int gone = row[k] & m.disjoint;
+                    row[k] &= ~gone;
+                    for (; gone != 0; gone &= gone - 1)
+                        nActive--;
+                }
+            }
+        } while (modified);
+        return ES_OK;
+    }
+
+public:
+    // Perform propagation
+    virtual ExecStatus propagate(Space &home, const ModEventDelta &) {
+        /**
+         * Run the pairwise rules over the active pairs until no bound changes anymore, so the propagator is
+         * idempotent. Pairs that can no longer overlap are dropped from the active set. The kernel only pays off
+         * from NoOverlapKernel::threshold squares on, below it the pairs are tested one at a time.
+         */
+        if (x.size() < NoOverlapKernel::threshold)
+            GECODE_ES_CHECK(pairs(home));
+        else
+            GECODE_ES_CHECK(kernel(home));
+
+        if (nActive == 0)
+            return home.ES_SUBSUMED(*this); //No variable domains can overlap no matter assignment, no more propagation necessary
+        return ES_FIX; //Fixpoint computed above, no need to be rescheduled for own modifications.
+    }
+
+    // Dispose propagator and return its size (dispose works as garbage collection, must cancel subscription first).
+    virtual size_t dispose(Space &home) {
+        home.ignore(*this, AP_DISPOSE);
+        x.cancel(home, *this, PC_INT_BND);
+        y.cancel(home, *this, PC_INT_BND);
+        w.~SharedArray();
+        h.~SharedArray();
+        (void) Propagator::dispose(home);
+        return sizeof(*this);
+    }
+};
+
+/*
+ * Sweep-based no-overlap propagator.
+ *
+ * Applies the same bounds rules as NoOverlap, but instead of testing all n^2 pairs it sorts the squares by their
+ * start on one axis and sweeps the compulsory parts along that axis. A sparse table of the largest starts finds the
+ * squares whose whole start range lies inside a compulsory part without visiting the others, so a call costs
+ * O(n log n) plus the number of pairs whose projections must overlap.
+ */
+class NoOverlapSweep : public Propagator {
+protected:
+    // The x-coordinates
+    ViewArray<IntView> x;
+    // The width (array)
+    SharedArray<int> w;
+    // The y-coordinates
+    ViewArray<IntView> y;
+    // The heights (array)
+    SharedArray<int> h;
+
+    // Orders square indices by a key array (smallest first), used for sorting the sweep events
+    class KeyLess {
+    public:
+        const int *key;
+
+        KeyLess(const int *k) : key(k) {}
+
+        bool operator()(const int a, const int b) const {
+            return key[a] < key[b];
+        }
+    };
+
+    /**
+     * Sweep the compulsory parts along axis u (start views u, sizes su) and apply the pairwise rules on axis v
+     * (start views v, sizes sv) for every pair whose u-projections must overlap.
+     * Only v is modified, so the sorted u-bounds stay valid for the whole sweep.
+     */
+    static ExecStatus sweep(Space &home, ViewArray<IntView> &u, const SharedArray<int> &su, ViewArray<IntView> &v, const SharedArray<int> &sv) {
+        int n = u.size();
+        Region r(home);
+        // Square indices sorted by the minimum of their u-start, and the sorted minimums and maximums themselves
+        int *order = r.alloc<int>(n);
+        int *umin = r.alloc<int>(n);
+        for (int i = n; i--;) {
+            order[i] = i;
+            umin[i] = u[i].min();
+        }
+        KeyLess lt(umin);
+        Support::quicksort<int, KeyLess>(order, n, lt);
+        int *smin = r.alloc<int>(n);
+        int *smax = r.alloc<int>(n);
+        for (int k = n; k--;) {
+            smin[k] = umin[order[k]];
+            smax[k] = u[order[k]].max();
+        }
+
+        // Sparse table over smax: least[l][k] is the position of the smallest maximum in [k, k + 2^l)
+        int levels = 1;
+        while ((1 << levels) <= n)
+            levels++;
+        int **least = r.alloc<int *>(levels);
+        least[0] = r.alloc<int>(n);
+        for (int k = n; k--;)
+            least[0][k] = k;
+        for (int l = 1; l < levels; ++l) {
+            least[l] = r.alloc<int>(n);
+            for (int k = 0; k + (1 << l) <= n; ++k) {
+                int a = least[l - 1][k], b = least[l - 1][k + (1 << (l - 1))];
+                least[l][k] = smax[b] < smax[a] ? b : a;
+            }
+        }
+        // Ranges [first, last) of sorted positions still to be searched for one compulsory part
+        int *first = r.alloc<int>(n + 1);
+        int *last = r.alloc<int>(n + 1);
+
+        for (int i = 0; i < n; ++i) {
+            //Compulsory part of square i on the u-axis is [u.max, u.min + size)
+            int lo = u[i].max();
+            int hi = u[i].min() + su[i];
+            if (lo >= hi)
+                continue;
+            //Squares whose u-start can not be smaller than the compulsory part start at l, the ones whose
+            //u-start can not be inside it start at g (binary searches)
+            int l = count_less(smin, n, lo);
+            int g = count_less(smin, n, hi);
+            //Every square in [l, g) whose u-start can not be after the compulsory part must overlap i on the u-axis.
+            //Split the range at its smallest maximum until that maximum is too large, so only those squares
+            //(and at most one more range per square) are visited.
+            int top = 0;
+            if (l < g) {
+                first[top] = l;
+                last[top] = g;
+                top++;
+            }
+            while (top > 0) {
+                top--;
+                int a = first[top], b = last[top];
+                int e = 0;
+                while ((1 << (e + 1)) <= b - a)
+                    e++;
+                int c = least[e][a], d = least[e][b - (1 << e)];
+                int k = smax[d] < smax[c] ? d : c;
+                if (smax[k] >= hi)
+                    continue;
+                if (a < k) {
+                    first[top] = a;
+                    last[top] = k;
+                    top++;
+                }
+                if (k + 1 < b) {
+                    first[top] = k + 1;
+                    last[top] = b;
+                    top++;
+                }
+                int j = order[k];
+                if (j == i)
+                    continue;
+                //square i and j overlaps on u-axis so propagate (bounds propagation) that they cant overlap on v-axis
+                if (v[i].max() <= v[j].min())
+                    GECODE_ME_CHECK(v[j].gq(home, v[i].min() + sv[i]));
+
+                if (v[i].min() + sv[i] > v[j].max())
+                    GECODE_ME_CHECK(v[i].gr(home, v[j].min()));
+
+                if (v[j].max() <= v[i].min())
+                    GECODE_ME_CHECK(v[i].gq(home, v[j].min() + sv[j]));
+
+                if (v[j].min() + sv[j] > v[i].max())
+                    GECODE_ME_CHECK(v[j].gr(home, v[i].min()));
+            }
+        }
+        return ES_OK;
+    }
+
+    /**
+     * Mark in hit[i] whether the envelope [u.min, u.max + size) of square i intersects the envelope of any other
+     * square. Uses sorted envelope starts and ends, so it runs in O(n log n).
+     */
+    static void envelopes(Space &home, const ViewArray<IntView> &u, const SharedArray<int> &su, bool *hit) {
+        int n = u.size();
+        Region r(home);
+        int *start = r.alloc<int>(n);
+        int *end = r.alloc<int>(n);
+        for (int i = n; i--;) {
+            start[i] = u[i].min();
+            end[i] = u[i].max() + su[i];
+        }
+        Support::quicksort<int>(start, n);
+        Support::quicksort<int>(end, n);
+        for (int i = 0; i < n; ++i) {
+            //Envelopes starting before i ends, minus the ones that also end before i starts, minus i itself
+            int starting = count_less(start, n, u[i].max() + su[i]);
+            int ended = count_less(end, n, u[i].min() + 1);
+            hit[i] = (starting - ended - 1) > 0;
+        }
+    }
+
+    // Number of elements in the sorted array a that are smaller than k
+    static int count_less(const int *a, int n, int k) {
+        int l = 0, g = n;
+        while (l < g) {
+            int m = (l + g) / 2;
+            if (a[m] < k)
+                l = m + 1;
+            else
+                g = m;
+        }
+        return l;
+    }
+
+public:
+    // Create propagator and initialize
+    NoOverlapSweep(Home home, ViewArray<IntView> &x0, const SharedArray<int> &w0, ViewArray<IntView> &y0, const SharedArray<int> &h0) :
+            Propagator(home),
+            x(x0),
+            w(w0),
+            y(y0),
+            h(h0) {
+        x.subscribe(home, *this, PC_INT_BND);
+        y.subscribe(home, *this, PC_INT_BND);
+        home.notice(*this, AP_DISPOSE);
+    }
+
+    // Post sweep no-overlap propagator
+    static ExecStatus post(Home home, ViewArray<IntView> &x, const SharedArray<int> &w, ViewArray<IntView> &y, const SharedArray<int> &h) {
+        // Only if there is something to propagate
+        if (x.size() > 1)
+            (void) new(home) NoOverlapSweep(home, x, w, y, h);
+        return ES_OK;
+    }
+
+    // Copy constructor during cloning
+    NoOverlapSweep(Space &home, bool share, NoOverlapSweep &p)
+            : Propagator(home, share, p) {
+        x.update(home, share, p.x);
+        y.update(home, share, p.y);
+        // Width and height never change, clones share them
+        w.update(home, share, p.w);
+        h.update(home, share, p.h);
+    }
+
+    // Create copy during cloning
+    virtual Propagator *copy(Space &home, bool share) {
+        return new(home) NoOverlapSweep(home, share, *this);
+    }
+
+    // Re-schedule function after propagator has been re-enabled
+    virtual void reschedule(Space &home) {
+        x.reschedule(home, *this, PC_INT_BND);
+        y.reschedule(home, *this, PC_INT_BND);
+    }
+
+    // Return cost (sorting dominates, so report expensive linear)
+    virtual PropCost cost(const Space &, const ModEventDelta &) const {
+        return PropCost::linear(PropCost::HI, 2 * x.size());
+    }
+
+    // Perform propagation
+    virtual ExecStatus propagate(Space &home, const ModEventDelta &) {
+        //Squares that must overlap on the x-axis can not overlap on the y-axis, and the other way around
+        GECODE_ES_CHECK(sweep(home, x, w, y, h));
+        GECODE_ES_CHECK(sweep(home, y, h, x, w));
+
+        if (x.assigned() && y.assigned())
+            return home.ES_SUBSUMED(*this); //All variables assigned, no more propagation necessary.
+
+        //Subsumed if no square can reach another square on both axes, the same test as NoOverlap but on envelopes
+        Region r(home);
+        bool *xHit = r.alloc<bool>(x.size());
+        bool *yHit = r.alloc<bool>(y.size());
+        envelopes(home, x, w, xHit);
+        envelopes(home, y, h, yHit);
+        for (int i = 0; i < x.size(); ++i)
+            if (xHit[i] && yHit[i])
+                return ES_NOFIX; //Propagator is not idempotent, max and min bounds might change and affect propagation.
+        return home.ES_SUBSUMED(*this); //No variable domains can overlap no matter assignment
+    }
+
+    // Dispose propagator and return its size
+    virtual size_t dispose(Space &home) {
+        home.ignore(*this, AP_DISPOSE);
+        x.cancel(home, *this, PC_INT_BND);
+        y.cancel(home, *this, PC_INT_BND);
+        w.~SharedArray();
+        h.~SharedArray();
+        (void) Propagator::dispose(home);
+        return sizeof(*this);
+    }
+};
+
+/*
+ * Incremental no-overlap propagator.
+ *
+ * Uses the same pairwise bounds rules as NoOverlap, but instead of subscribing the propagator to every view it
+ * attaches an advisor to each coordinate. The advisors record which squares changed since the last run, and
+ * propagation only re-examines the pairs that involve one of those squares.
+ */
+class NoOverlapIncremental : public Propagator {
+protected:
+    // Advisor for one coordinate of a square, remembers which square it belongs to
+    class SquareAdvisor : public ViewAdvisor<IntView> {
+    public:
+        // Index of the square
+        int i;
+
+        // Create advisor for coordinate x0 of square i0
+        SquareAdvisor(Space &home, Propagator &p, Council<SquareAdvisor> &c, IntView x0, int i0)
+                : ViewAdvisor<IntView>(home, p, c, x0), i(i0) {}
+
+        // Copy advisor during cloning
+        SquareAdvisor(Space &home, bool share, SquareAdvisor &a)
+                : ViewAdvisor<IntView>(home, share, a), i(a.i) {}
+
+        // Dispose advisor
+        void dispose(Space &home, Council<SquareAdvisor> &c) {
+            ViewAdvisor<IntView>::dispose(home, c);
+        }
+    };
+
+    // The x-coordinates
+    ViewArray<IntView> x;
+    // The width (array)
+    SharedArray<int> w;
+    // The y-coordinates
+    ViewArray<IntView> y;
+    // The heights (array)
+    SharedArray<int> h;
+    // The advisors, one per unassigned coordinate
+    Council<SquareAdvisor> c;
+    // Squares changed since the last propagation (first nChanged entries are valid)
+    int *changed;
+    int nChanged;
+    // Whether a square is already recorded in changed
+    bool *marked;
+    // Number of coordinates that are not yet assigned, all assigned means subsumption
+    int unassigned;
+
+    // Record that square i has changed
+    void touch(int i) {
+        if (!marked[i]) {
+            marked[i] = true;
+            changed[nChanged++] = i;
+        }
+    }
+
+public:
+    // Create propagator and initialize, every square counts as changed for the first propagation
+    NoOverlapIncremental(Home home, ViewArray<IntView> &x0, const SharedArray<int> &w0, ViewArray<IntView> &y0, const SharedArray<int> &h0) :
+            Propagator(home),
+            x(x0),
+            w(w0),
+            y(y0),
+            h(h0),
+            c(home),
+            nChanged(0),
+            unassigned(0) {
+        changed = static_cast<Space &>(home).alloc<int>(x.size());
+        marked = static_cast<Space &>(home).alloc<bool>(x.size());
+        for (int i = 0; i < x.size(); ++i) {
+            marked[i] = false;
+            touch(i);
+            //Assigned coordinates never change again, so they do not need an advisor
+            if (!x[i].assigned()) {
+                (void) new(home) SquareAdvisor(home, *this, c, x[i], i);
+                unassigned++;
+            }
+            if (!y[i].assigned()) {
+                (void) new(home) SquareAdvisor(home, *this, c, y[i], i);
+                unassigned++;
+            }
+        }
+        //Advisors do not schedule the propagator on posting, so schedule the initial run explicitly
+        IntView::schedule(home, *this, ME_INT_BND);
+        home.notice(*this, AP_DISPOSE);
+    }
+
+    // Post incremental no-overlap propagator
+    static ExecStatus post(Home home, ViewArray<IntView> &x, const SharedArray<int> &w, ViewArray<IntView> &y, const SharedArray<int> &h) {
+        // Only if there is something to propagate
+        if (x.size() > 1)
+            (void) new(home) NoOverlapIncremental(home, x, w, y, h);
+        return ES_OK;
+    }
+
+    // Copy constructor during cloning
+    NoOverlapIncremental(Space &home, bool share, NoOverlapIncremental &p)
+            : Propagator(home, share, p), nChanged(p.nChanged), unassigned(p.unassigned) {
+        x.update(home, share, p.x);
+        y.update(home, share, p.y);
+        c.update(home, share, p.c);
+        // Width and height never change, clones share them
+        w.update(home, share, p.w);
+        h.update(home, share, p.h);
+        // Also copy the changed squares
+        changed = home.alloc<int>(x.size());
+        marked = home.alloc<bool>(x.size());
+        for (int i = x.size(); i--;) {
+            changed[i] = p.changed[i];
+            marked[i] = p.marked[i];
+        }
+    }
+
+    // Create copy during cloning
+    virtual Propagator *copy(Space &home, bool share) {
+        return new(home) NoOverlapIncremental(home, share, *this);
+    }
+
+    // Re-schedule function after propagator has been re-enabled
+    virtual void reschedule(Space &home) {
+        IntView::schedule(home, *this, ME_INT_BND);
+    }
+
+    // Return cost (linear, only the changed squares are compared against the others)
+    virtual PropCost cost(const Space &, const ModEventDelta &) const {
+        return PropCost::linear(PropCost::HI, 2 * x.size());
+    }
+
+    // Record the square whose coordinate changed
+    virtual ExecStatus advise(Space &home, Advisor &a, const Delta &d) {
+        SquareAdvisor &sa = static_cast<SquareAdvisor &>(a);
+        //Holes in the domain do not affect the bounds rules
+        if (IntView::modevent(d) == ME_INT_DOM)
+            return ES_FIX;
+        touch(sa.i);
+        if (sa.view().assigned()) {
+            unassigned--;
+            return home.ES_NOFIX_DISPOSE(c, sa); //Assigned coordinate will not change again, drop its advisor
+        }
+        return ES_NOFIX;
+    }
+
+    // Perform propagation
+    virtual ExecStatus propagate(Space &home, const ModEventDelta &) {
+        //Take the changed squares, changes made during this run are recorded again by the advisors
+        Region r(home);
+        int k = nChanged;
+        int *todo = r.alloc<int>(k);
+        for (int t = k; t--;) {
+            todo[t] = changed[t];
+            marked[changed[t]] = false;
+        }
+        nChanged = 0;
+
+        bool modified = false;
+        for (int t = 0; t < k; ++t) {
+            int i = todo[t];
+            for (int j = 0; j < x.size(); ++j)
+                if (j != i)
+                    GECODE_ES_CHECK(noOverlapPair(home, x, w, y, h, i, j, modified));
+        }
+
+        if (unassigned == 0)
+            return home.ES_SUBSUMED(*this); //All variables assigned, no more propagation necessary.
+        //Own modifications have been recorded by the advisors and need another run, otherwise at fixpoint
+        return modified ? ES_NOFIX : ES_FIX;
+    }
+
+    // Dispose propagator and return its size
+    virtual size_t dispose(Space &home) {
+        home.ignore(*this, AP_DISPOSE);
+        c.dispose(home);
+        w.~SharedArray();
+        h.~SharedArray();
+        (void) Propagator::dispose(home);
+        return sizeof(*this);
+    }
+};
+
+/*
+ * Energetic reasoning for no-overlap.
+ *
+ * Projects the squares on one axis, where they form a cumulative resource whose capacity is the extent of the
+ * squares on the other axis. For every interval [a, b) between a start and an end of a square, the area the
+ * squares must occupy inside the interval is compared against the available area (failure), and squares are
+ * pushed out of an interval that can not take their left or right shifted part (bounds adjustment).
+ * This catches conflicts between several squares that the pairwise rules miss, at cubic cost per call.
+ * Posted by nooverlap() in addition to the pairwise propagator for IPL_DOM.
+ */
+class NoOverlapEnergy : public Propagator {
+protected:
+    // The x-coordinates
+    ViewArray<IntView> x;
+    // The width (array)
+    SharedArray<int> w;
+    // The y-coordinates
+    ViewArray<IntView> y;
+    // The heights (array)
+    SharedArray<int> h;
+
+    // Part of a square of size l starting at s that lies inside [a, b)
+    static int overlap(int s, int l, int a, int b) {
+        return std::max(0, std::min(b, s + l) - std::max(a, s));
+    }
+
+    // Part of [a, b) that square i (start view u, size l) occupies wherever it is placed
+    static int required(const IntView &u, int l, int a, int b) {
+        return std::max(0, std::min(std::min(b - a, l), std::min(u.min() + l - a, b - u.max())));
+    }
+
+    /**
+     * Energetic reasoning along axis u (start views u, sizes su), every square using sv of the capacity.
+     * The capacity is the extent of all squares along v.
+     */
+    static ExecStatus energy(Space &home, ViewArray<IntView> &u, const SharedArray<int> &su,
+                             const ViewArray<IntView> &v, const SharedArray<int> &sv, bool &modified) {
+        int n = u.size();
+        int vlo = v[0].min(), vhi = v[0].max() + sv[0];
+        for (int i = 1; i < n; ++i) {
+            vlo = std::min(vlo, v[i].min());
+            vhi = std::max(vhi, v[i].max() + sv[i]);
+        }
+        long capacity = vhi - vlo;
+
+        //Candidate interval starts (earliest starts) and ends (earliest and latest ends)
+        Region r(home);
+        int *starts = r.alloc<int>(n);
+        int *ends = r.alloc<int>(2 * n);
+        for (int i = n; i--;) {
+            starts[i] = u[i].min();
+            ends[2 * i] = u[i].min() + su[i];
+            ends[2 * i + 1] = u[i].max() + su[i];
+        }
+        int nStarts = unique(starts, n);
+        int nEnds = unique(ends, 2 * n);
+
+        for (int sa = 0; sa < nStarts; ++sa)
+            for (int eb = 0; eb < nEnds; ++eb) {
+                int a = starts[sa], b = ends[eb];
+                if (b <= a)
+                    continue;
+                long e = 0;
+                for (int i = n; i--;)
+                    e += static_cast<long>(sv[i]) * required(u[i], su[i], a, b);
+                long available = capacity * (b - a);
+                if (e > available)
+                    return ES_FAILED; //The squares do not fit into the interval
+                for (int i = n; i--;) {
+                    if (u[i].assigned())
+                        continue;
+                    //Number of positions of [a, b) square i may occupy next to the others
+                    long slack = available - (e - static_cast<long>(sv[i]) * required(u[i], su[i], a, b));
+                    long k = slack / sv[i];
+                    if (k < overlap(u[i].min(), su[i], a, b)) {
+                        //Left shifted i takes too much of [a, b), so it must start late enough to leave it
+                        ModEvent me = u[i].gq(home, static_cast<int>(b - k));
+                        if (me_failed(me))
+                            return ES_FAILED;
+                        if (me_modified(me))
+                            modified = true;
+                    }
+                    if (k < overlap(u[i].max(), su[i], a, b)) {
+                        //Right shifted i takes too much of [a, b), so it must end early enough
+                        ModEvent me = u[i].lq(home, static_cast<int>(a + k - su[i]));
+                        if (me_failed(me))
+                            return ES_FAILED;
+                        if (me_modified(me))
+                            modified = true;
+                    }
+                }
+            }
+        return ES_OK;
+    }
+
+    // Sort the first n values of a and remove duplicates, returns the number of distinct values
+    static int unique(int *a, int n) {
+        Support::quicksort<int>(a, n);
+        int m = 0;
+        for (int i = 0; i < n; ++i)
+            if ((m == 0) || (a[m - 1] != a[i]))
+                a[m++] = a[i];
+        return m;
+    }
+
+public:
+    // Create propagator and initialize
+    NoOverlapEnergy(Home home, ViewArray<IntView> &x0, const SharedArray<int> &w0, ViewArray<IntView> &y0, const SharedArray<int> &h0) :
+            Propagator(home),
+            x(x0),
+            w(w0),
+            y(y0),
+            h(h0) {
+        x.subscribe(home, *this, PC_INT_BND);
+        y.subscribe(home, *this, PC_INT_BND);
+        home.notice(*this, AP_DISPOSE);
+    }
+
+    // Post energetic no-overlap propagator
+    static ExecStatus post(Home home, ViewArray<IntView> &x, const SharedArray<int> &w, ViewArray<IntView> &y, const SharedArray<int> &h) {
+        // Only if there is something to propagate
+        if (x.size() > 1)
+            (void) new(home) NoOverlapEnergy(home, x, w, y, h);
+        return ES_OK;
+    }
+
+    // Copy constructor during cloning
+    NoOverlapEnergy(Space &home, bool share, NoOverlapEnergy &p)
+            : Propagator(home, share, p) {
+        x.update(home, share, p.x);
+        y.update(home, share, p.y);
+        // Width and height never change, clones share them
+        w.update(home, share, p.w);
+        h.update(home, share, p.h);
+    }
+
+    // Create copy during cloning
+    virtual Propagator *copy(Space &home, bool share) {
+        return new(home) NoOverlapEnergy(home, share, *this);
+    }
+
+    // Re-schedule function after propagator has been re-enabled
+    virtual void reschedule(Space &home) {
+        x.reschedule(home, *this, PC_INT_BND);
+        y.reschedule(home, *this, PC_INT_BND);
+    }
+
+    // Return cost (cubic: intervals times squares)
+    virtual PropCost cost(const Space &, const ModEventDelta &) const {
+        return PropCost::cubic(PropCost::HI, 2 * x.size());
+    }
+
+    // Perform propagation
+    virtual ExecStatus propagate(Space &home, const ModEventDelta &) {
+        bool modified = false;
+        GECODE_ES_CHECK(energy(home, x, w, y, h, modified));
+        GECODE_ES_CHECK(energy(home, y, h, x, w, modified));
+        if (x.assigned() && y.assigned())
+            return home.ES_SUBSUMED(*this); //All variables assigned, no more propagation necessary.
+        //Adjusted bounds change the required areas, so the propagator is not idempotent
+        return modified ? ES_NOFIX : ES_FIX;
+    }
+
+    // Dispose propagator and return its size
+    virtual size_t dispose(Space &home) {
+        home.ignore(*this, AP_DISPOSE);
+        x.cancel(home, *this, PC_INT_BND);
+        y.cancel(home, *this, PC_INT_BND);
+        w.~SharedArray();
+        h.~SharedArray();
+        (void) Propagator::dispose(home);
+        return sizeof(*this);
+    }
+};
+
+/**
+ * Propagation algorithm used by nooverlap()
+ */
+enum NoOverlapAlgorithm {
+    NOOVERLAP_PAIRWISE, // Pairwise bounds reasoning over all n^2 pairs (NoOverlap)
+    NOOVERLAP_SWEEP,    // Same rules, driven by a sweep over the compulsory parts (NoOverlapSweep)
+    NOOVERLAP_INCREMENTAL // Same rules, only for pairs involving squares changed since the last run (NoOverlapIncremental)
+};
+
+/*
+ * Post the constraint that the rectangles defined by the coordinates
+ * x and y and width w and height h do not overlap.
+ *
+ * This is the function that you will call from your model. The best
+ * is to paste the entire file into your model.
+ *
+ * Post function checks whether arguments are correct and whether the the space is failed or not before posting the
+ * propagator.
+ *
+ * With ipl = IPL_DOM energetic reasoning (NoOverlapEnergy) is posted in addition to the selected algorithm.
+ */
+void nooverlap(Space &home,
+               const IntVarArgs &x, const IntArgs &w,
+               const IntVarArgs &y, const IntArgs &h,
+               NoOverlapAlgorithm algorithm = NOOVERLAP_PAIRWISE,
+               IntPropLevel ipl = IPL_DEF) {
+    // Check whether the arguments make sense
+    if ((x.size() != y.size()) || (x.size() != w.size()) ||
+        (y.size() != h.size()))
+        throw ArgumentSizeMismatch("nooverlap");
+    // Never post a propagator in a failed space
+    if (home.failed()) return;
+    // Set up array of views for the coordinates
+    ViewArray<IntView> vx(home, x);
+    ViewArray<IntView> vy(home, y);
+    // Set up arrays for width and height and initialize, they are shared by all clones
+    SharedArray<int> wc(x.size());
+    SharedArray<int> hc(y.size());
+    for (int i = x.size(); i--;) {
+        wc[i] = w[i];
+        hc[i] = h[i];
+    }
+    // Post the propagator for the requested algorithm, if posting failed, fail space
+    ExecStatus es;
+    switch (algorithm) {
+        case NOOVERLAP_SWEEP:
+            es = NoOverlapSweep::post(home, vx, wc, vy, hc);
+            break;
+        case NOOVERLAP_INCREMENTAL:
+            es = NoOverlapIncremental::post(home, vx, wc, vy, hc);
+            break;
+        default:
+            es = NoOverlap::post(home, vx, wc, vy, hc);
+            break;
+    }
+    // Stronger filtering level, trade propagation cost for fewer failures
+    if ((es == ES_OK) && (vbd(ipl) == IPL_DOM))
+        es = NoOverlapEnergy::post(home, vx, wc, vy, hc);
+    if (es != ES_OK)
+        home.fail();
+}
+
+/*
+ * Occupancy profile propagator (timetable reasoning for one axis).
+ *
+ * Every square occupies w[i] consecutive columns starting at x[i] and uses h[i] of each column it covers.
+ * The squares covering a column must fit into the enclosing square, so the total usage of every column is at
+ * most s. The propagator builds the profile of the compulsory parts [x.max, x.min + w), raises s to its peak and
+ * removes every start from x[i] that would put square i on a column without enough room left.
+ * This is the same pruning as one reified dom() per square and column plus one linear per column, but as one
+ * propagator over all columns.
+ */
+class OccupancyProfile : public Propagator {
+protected:
+    // The start coordinates along the axis
+    ViewArray<IntView> x;
+    // The extent along the axis (array)
+    SharedArray<int> w;
+    // The usage of every covered column (array)
+    SharedArray<int> h;
+    // The capacity of every column
+    IntView s;
+    // Only tighten the bounds of the starts (-ipl bnd or val), otherwise also remove the starts in between
+    bool bounds;
+
+public:
+    // Create propagator and initialize
+    OccupancyProfile(Home home, ViewArray<IntView> &x0, const SharedArray<int> &w0, const SharedArray<int> &h0, IntView s0,
+                     bool bounds0) :
+            Propagator(home),
+            x(x0),
+            w(w0),
+            h(h0),
+            s(s0),
+            bounds(bounds0) {
+        x.subscribe(home, *this, PC_INT_BND);
+        s.subscribe(home, *this, PC_INT_BND);
+        home.notice(*this, AP_DISPOSE);
+    }
+
+    // Post occupancy profile propagator
+    static ExecStatus post(Home home, ViewArray<IntView> &x, const SharedArray<int> &w, const SharedArray<int> &h, IntView s,
+                           bool bounds) {
+        (void) new(home) OccupancyProfile(home, x, w, h, s, bounds);
+        return ES_OK;
+    }
+
+    // Copy constructor during cloning
+    OccupancyProfile(Space &home, bool share, OccupancyProfile &p)
+            : Propagator(home, share, p), bounds(p.bounds) {
+        x.update(home, share, p.x);
+        s.update(home, share, p.s);
+        // Extent and usage never change, clones share them
+        w.update(home, share, p.w);
+        h.update(home, share, p.h);
+    }
+
+    // Create copy during cloning
+    virtual Propagator *copy(Space &home, bool share) {
+        return new(home) OccupancyProfile(home, share, *this);
+    }
+
+    // Re-schedule function after propagator has been re-enabled
+    virtual void reschedule(Space &home) {
+        x.reschedule(home, *this, PC_INT_BND);
+        s.reschedule(home, *this, PC_INT_BND);
+    }
+
+    // Return cost (cheap quadratic: every square is scanned over the columns its domain can cover)
+    virtual PropCost cost(const Space &, const ModEventDelta &) const {
+        return PropCost::quadratic(PropCost::LO, x.size());
+    }
+
+    // Perform propagation
+    virtual ExecStatus propagate(Space &home, const ModEventDelta &) {
+        int n = x.size();
+        //Columns that any square can cover
+        int lo = x[0].min(), hi = x[0].max() + w[0];
+        for (int i = 1; i < n; ++i) {
+            lo = std::min(lo, x[i].min());
+            hi = std::max(hi, x[i].max() + w[i]);
+        }
+
+        //Profile of the compulsory parts
+        Region r(home);
+        int *profile = r.alloc<int>(hi - lo);
+        for (int c = hi - lo; c--;)
+            profile[c] = 0;
+        int peak = 0;
+        for (int i = 0; i < n; ++i)
+            for (int c = x[i].max(); c < x[i].min() + w[i]; ++c) {
+                profile[c - lo] += h[i];
+                peak = std::max(peak, profile[c - lo]);
+            }
+
+        //Enclosing square must be at least as large as the most used column
+        GECODE_ME_CHECK(s.gq(home, peak));
+        int capacity = s.max();
+
+        //Remove the starts that would place square i on a column where it does not fit
+        bool modified = false;
+        Iter::Ranges::Array::Range *forbidden = r.alloc<Iter::Ranges::Array::Range>(hi - lo);
+        for (int i = 0; i < n; ++i) {
+            if (x[i].assigned())
+                continue;
+            int m = 0;
+            for (int c = x[i].min(); c < x[i].max() + w[i]; ++c) {
+                //Usage of the column by the other squares
+                int used = profile[c - lo];
+                if ((c >= x[i].max()) && (c < x[i].min() + w[i]))
+                    used -= h[i];
+                if (used + h[i] <= capacity)
+                    continue;
+                //Square i must not cover column c, so it can not start in [c - w + 1, c]
+                if ((m > 0) && (forbidden[m - 1].max >= c - w[i]))
+                    forbidden[m - 1].max = c;
+                else {
+                    forbidden[m].min = c - w[i] + 1;
+                    forbidden[m].max = c;
+                    m++;
+                }
+            }
+            if ((m > 0) && bounds) {
+                //Only the forbidden starts at either end of the domain, the ranges are sorted and separated
+                int first = x[i].min(), last = x[i].max();
+                for (int k = 0; (k < m) && (forbidden[k].min <= first); ++k)
+                    first = std::max(first, forbidden[k].max + 1);
+                for (int k = m; k-- && (forbidden[k].max >= last);)
+                    last = std::min(last, forbidden[k].min - 1);
+                if ((first > x[i].min()) || (last < x[i].max()))
+                    modified = true;
+                GECODE_ME_CHECK(x[i].gq(home, first));
+                GECODE_ME_CHECK(x[i].lq(home, last));
+            } else if (m > 0) {
+                Iter::Ranges::Array ranges(forbidden, m);
+                ModEvent me = x[i].minus_r(home, ranges, false);
+                if (me_failed(me))
+                    return ES_FAILED;
+                if (me_modified(me))
+                    modified = true;
+            }
+        }
+
+        if (x.assigned())
+            return home.ES_SUBSUMED(*this); //Profile is final and s is at least its peak
+        //New bounds can create new compulsory parts
+        return modified ? ES_NOFIX : ES_FIX;
+    }
+
+    // Dispose propagator and return its size
+    virtual size_t dispose(Space &home) {
+        home.ignore(*this, AP_DISPOSE);
+        x.cancel(home, *this, PC_INT_BND);
+        s.cancel(home, *this, PC_INT_BND);
+        w.~SharedArray();
+        h.~SharedArray();
+        (void) Propagator::dispose(home);
+        return sizeof(*this);
+    }
+};
+
+/*
+ * Post the constraint that the squares with start coordinates x, extent w and usage h never use more than s of
+ * any column along the axis of x (redundant with nooverlap() inside an s x s square, but prunes more).
+ * With ipl bnd or val only the bounds of the starts are tightened, otherwise every start that does not fit is removed.
+ */
+void occupancy(Space &home, const IntVarArgs &x, const IntArgs &w, const IntArgs &h, IntVar s,
+               IntPropLevel ipl = IPL_DEF) {
+    // Check whether the arguments make sense
+    if ((x.size() != w.size()) || (x.size() != h.size()))
+        throw ArgumentSizeMismatch("occupancy");
+    // Never post a propagator in a failed space
+    if (home.failed()) return;
+    if (x.size() == 0) return;
+    ViewArray<IntView> vx(home, x);
+    SharedArray<int> wc(x.size());
+    SharedArray<int> hc(x.size());
+    for (int i = x.size(); i--;) {
+        wc[i] = w[i];
+        hc[i] = h[i];
+    }
+    // If posting failed, fail space
+    bool bounds = (vbd(ipl) == IPL_BND) || (vbd(ipl) == IPL_VAL);
+    if (OccupancyProfile::post(home, vx, wc, hc, s, bounds) != ES_OK)
+        home.fail();
+}
+
+#include <gecode/driver.hh>
+#include <gecode/int.hh>
+#include <gecode/minimodel.hh>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "thread_count.hpp"
+
+using namespace Gecode;
+
+/**
+ * ObligatoryPartSizeOptions for choosing how large the obligatory part in interval-branching should be in percentage.
+ */
+class ObligatoryPartSizeOptions : public Options {
+private:
+    Driver::DoubleOption _obligatory;
+    Driver::DoubleOption _obligatorySmall;
+    Driver::UnsignedIntOption _alternatives;
+    Driver::UnsignedIntOption _dimension;
+    Driver::StringValueOption _portfolio;
+    Driver::UnsignedIntOption _memo;
+    Driver::UnsignedIntOption _presolve;
+    Driver::UnsignedIntOption _sweep;
+    Driver::StringValueOption _cache;
+    Driver::StringOption _sink;
+    Driver::StringValueOption _output;
+public :
+    ObligatoryPartSizeOptions(const char *e) :
+            Options(e),
+            _obligatory("-obligatory", "Obligatory part size in percentage 0.0-1.0", 0.35),
+            _obligatorySmall("-obligatory-small", "Obligatory part size for the smallest square, interpolated up to -obligatory for the largest (0 = same as -obligatory)", 0.0),
+            _alternatives("-alternatives", "Maximal number of intervals per interval-2d choice (>= 2)", 2),
+            _dimension("-dimension", "Square dimension integer > 1", 2),
+            _portfolio("-portfolio", "race one search per configuration p[:branching], comma separated (e.g. 0.2,0.35:afc,0.5)"),
+            _memo("-memo", "Entries of the failed packing memo for -branching corner (0 = off)", 0),
+            _presolve("-presolve", "Node limit per probe of the shaving stage before search (0 = off)", 0),
+            _sweep("-sweep", "Solve the dimensions -dimension ... sweep for the smallest enclosing size (0 = off)", 0),
+            _cache("-cache", "File with the optimal enclosing sizes proven by earlier sweeps"),
+            _sink("-sink", "Solution output", 0),
+            _output("-output", "File for -sink text and -sink binary (default: standard output)"){
+        _sink.add(0, "print", "print every solution through the driver");
+        _sink.add(1, "count", "only count solutions");
+        _sink.add(2, "text", "one line per solution: s x0 y0 x1 y1 ...");
+        _sink.add(3, "binary", "fixed-width 32-bit records: s x0 y0 x1 y1 ...");
+        add(_obligatory);
+        add(_obligatorySmall);
+        add(_alternatives);
+        add(_dimension);
+        add(_portfolio);
+        add(_memo);
+        add(_presolve);
+        add(_sweep);
+        add(_cache);
+        add(_sink);
+        add(_output);
+    }
+
+    void parse(int &argc, char *argv[]) {
+        Options::parse(argc, argv);
+        //The interval branchers divide by the obligatory part, which must be a positive share of the side
+        if ((obligatory() <= 0.0) || (obligatory() > 1.0)) {
+            std::cerr << "Error: -obligatory must be in (0, 1]" << std::endl;
+            std::exit(EXIT_FAILURE);
+        }
+        if ((obligatorySmall() < 0.0) || (obligatorySmall() > 1.0)) {
+            std::cerr << "Error: -obligatory-small must be in (0, 1], or 0 for the value of -obligatory" << std::endl;
+            std::exit(EXIT_FAILURE);
+        }
+        //A choice with fewer than two intervals would not split anything
+        if (alternatives() < 2) {
+            std::cerr << "Error: -alternatives must be at least 2" << std::endl;
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    double obligatory(void) const {
+        return _obligatory.value();
+    }
+
+    double obligatorySmall(void) const {
+        return _obligatorySmall.value();
+    }
+
+    unsigned int alternatives(void) const {
+        return _alternatives.value();
+    }
+
+    int dimension(void) const {
+        return _dimension.value();
+    }
+
+    void dimension(int n) {
+        _dimension.value(n);
+    }
+
+    const char *portfolio(void) const {
+        return _portfolio.value();
+    }
+
+    unsigned int memo(void) const {
+        return _memo.value();
+    }
+
+    unsigned int presolve(void) const {
+        return _presolve.value();
+    }
+
+    int sweep(void) const {
+        return _sweep.value();
+    }
+
+    const char *cache(void) const {
+        return _cache.value();
+    }
+
+    int sink(void) const {
+        return _sink.value();
+    }
+
+    const char *output(void) const {
+        return _output.value();
+    }
+};
+
+/**
+ * Bounds on the enclosing size s of dimension n, used by FixedSquareTable at compile time and by SquareTable at
+ * run time.
+ */
+// Smallest r in [lo, hi] with r * r >= a (bisection, so the recursion stays shallow)
+constexpr int ceilSqrt(long long int a, int lo, int hi) {
+    return lo >= hi ? lo :
+           static_cast<long long int>((lo + hi) / 2) * ((lo + hi) / 2) >= a ? ceilSqrt(a, lo, (lo + hi) / 2) :
+           ceilSqrt(a, (lo + hi) / 2 + 1, hi);
+}
+
+// Stacked upper bound: the squares side by side
+constexpr int stackedBound(int n) {
+    return n * (n + 1) / 2;
+}
+
+// Area lower bound: s * s >= 1 + 4 + ... + n * n
+constexpr int areaBound(int n) {
+    return ceilSqrt(static_cast<long long int>(n) * (n + 1) * (2 * n + 1) / 6, 0, stackedBound(n));
+}
+
+// Lower bound from the area and from the two largest squares: squares n and n - 1 must be separated along x or y, so
+// they need n + n - 1 along that axis (the better bound up to n = 8)
+constexpr int lowerBound(int n) {
+    return n > 1 && 2 * n - 1 > areaBound(n) ? 2 * n - 1 : areaBound(n);
+}
+
+// Compile-time index list 0 ... K - 1, for filling constexpr arrays
+template<int... I>
+struct Indices {
+};
+
+template<int K, int... I>
+struct MakeIndices : MakeIndices<K - 1, K - 1, I...> {
+};
+
+template<int... I>
+struct MakeIndices<0, I...> {
+    typedef Indices<I...> type;
+};
+
+/**
+ * Sizes, bounds and empty-strip gaps of dimension N (index i is the square of size N - i) as constexpr arrays, computed
+ * when the program is compiled.
+ */
+template<int N, class I = typename MakeIndices<N - 1>::type>
+struct FixedSquareTable;
+
+template<int N, int... I>
+struct FixedSquareTable<N, Indices<I...> > {
+    static constexpr int area = areaBound(N), lower = lowerBound(N), stacked = stackedBound(N);
+    static constexpr int size[N - 1] = {(N - I)...};
+    static constexpr int gap[N - 1] = {SquareGaps::generic(N - I)...};
+    static constexpr int specific[N - 1] = {SquareGaps::specific(N - I)...};
+};
+
+template<int N, int... I>
+constexpr int FixedSquareTable<N, Indices<I...> >::size[N - 1];
+template<int N, int... I>
+constexpr int FixedSquareTable<N, Indices<I...> >::gap[N - 1];
+template<int N, int... I>
+constexpr int FixedSquareTable<N, Indices<I...> >::specific[N - 1];
+
+// Dimensions with a FixedSquareTable
+constexpr int fixedMin = 2, fixedMax = 32;
+
+/**
+ * Sizes, bounds and empty-strip gaps of dimension n (index i is the square of size n - i), read when the model is
+ * posted. Dimensions fixedMin ... fixedMax point into FixedSquareTable<n> through a dispatch table, other dimensions
+ * fill arrays of their own with the same functions.
+ */
+class SquareTable {
+protected:
+    // Arrays of the dimensions without a FixedSquareTable
+    std::vector<int> sizes, gaps, specifics;
+
+    // Entry of the dispatch table
+    struct Fixed {
+        int area, lower, stacked;
+        const int *size, *gap, *specific;
+    };
+
+    // Dispatch table, entry k is dimension fixedMin + k
+    template<int... I>
+    static const Fixed *fixed(Indices<I...>) {
+        static const Fixed tables[] = {
+                {FixedSquareTable<fixedMin + I>::area, FixedSquareTable<fixedMin + I>::lower,
+                 FixedSquareTable<fixedMin + I>::stacked, FixedSquareTable<fixedMin + I>::size,
+                 FixedSquareTable<fixedMin + I>::gap, FixedSquareTable<fixedMin + I>::specific}...
+        };
+        return tables;
+    }
+
+public:
+    int n;
+    // Area and combined lower bound and stacked upper bound on s
+    int area, lower, stacked;
+    // Size, generic gap and specific gap of the n - 1 squares (gap -1 if none)
+    const int *size, *gap, *specific;
+
+    SquareTable(int n0) : n(n0) {
+        if ((n >= fixedMin) && (n <= fixedMax)) {
+            const Fixed &f = fixed(MakeIndices<fixedMax - fixedMin + 1>::type())[n - fixedMin];
+            area = f.area;
+            lower = f.lower;
+            stacked = f.stacked;
+            size = f.size;
+            gap = f.gap;
+            specific = f.specific;
+            return;
+        }
+        for (int i = 0; i < n - 1; ++i) {
+            sizes.push_back(n - i);
+            gaps.push_back(SquareGaps::generic(n - i));
+            specifics.push_back(SquareGaps::specific(n - i));
+        }
+        area = areaBound(n);
+        lower = lowerBound(n);
+        stacked = stackedBound(n);
+        size = sizes.data();
+        gap = gaps.data();
+        specific = specifics.data();
+    }
+
+    // The arrays may point into the table itself
+    SquareTable(const SquareTable &) = delete;
+};
+
+class SquarePacking : public Script {
+
+public:
+    /**
+     * Propagation variants for the no-overlap constraint (selected with -propagation)
+     */
+    enum {
+        PROP_PAIRWISE, //Pairwise no-overlap propagator
+        PROP_SWEEP,    //Sweep-line no-overlap propagator
+        PROP_INCREMENTAL //Advisor-based incremental no-overlap propagator
+    };
+
+    /**
+     * Interval branching variants (selected with -model)
+     */
+    enum {
+        MODEL_INTERVAL_2D, //One interval brancher over x and y, choosing square and axis dynamically
+        MODEL_INTERVAL_XY  //Interval branching over all x-coordinates, then over all y-coordinates
+    };
+
+    /**
+     * Search variants (selected with -search)
+     */
+    enum {
+        SEARCH_DFS,       //One DFS over the whole model, s is the first branching
+        SEARCH_PARALLEL_S, //One DFS per enclosing size s on a pool of threads
+        SEARCH_PROCESSES   //Subtrees handed out as archived paths to worker processes
+    };
+
+    /**
+     * Solution output (selected with -sink)
+     */
+    enum {
+        SINK_PRINT, //Gecode driver, print() for every solution
+        SINK_COUNT, //Only count solutions
+        SINK_TEXT,  //One line per solution through a buffered writer
+        SINK_BINARY //Fixed-width binary records through a buffered writer
+    };
+
+    /**
+     * Symmetry breaking (selected with -symmetry)
+     */
+    enum {
+        SYMMETRY_LARGEST, //Largest square below the diagonal in the left half, empty-strip dominance
+        SYMMETRY_NONE,    //All packings
+        SYMMETRY_DIHEDRAL //Lex-leader of the 8 symmetries of the enclosing square, one packing per class
+    };
+
+    /**
+     * Coordinate branching heuristics after interval branching (selected with -branching)
+     */
+    enum {
+        BRANCH_SIZE,  //Smallest domain first
+        BRANCH_AFC,   //Largest accumulated failure count / domain size first
+        BRANCH_DEGREE, //Largest degree first
+        BRANCH_CORNER  //Place squares together at the bottom-left free cell
+    };
+
+    const int n;
+    const double p;
+    const int symmetry;
+    IntVar s;
+    IntVarArray xCoords, yCoords;
+
+    /**
+     * Model given by opt. Corner-point branching records failed partial packings in memo unless it is NULL (only
+     * solveWithMemo() passes one).
+     */
+    SquarePacking(const ObligatoryPartSizeOptions &opt, SkylineMemo *memo = NULL) :
+            SquarePacking(opt, opt.obligatory(), opt.branching(), 0, memo) {}
+
+    /**
+     * Model with obligatory part percentage p0 and coordinate heuristic branching instead of the ones given by opt,
+     * used for the configurations of a portfolio.
+     * If fixed > 0 the model is the subproblem for s = fixed only: coordinates get their exact domains
+     * [0, fixed - t.size[i]] instead of constraints on [0, stacked], which keeps every clone small.
+     */
+    SquarePacking(const ObligatoryPartSizeOptions &opt, double p0, int branching, int fixed = 0,
+                  SkylineMemo *memo = NULL) :
+            SquarePacking(opt, p0, branching, fixed, memo, SquareTable(opt.dimension())) {}
+
+protected:
+    /**
+     * Model posted from the sizes, bounds and gaps in t
+     */
+    SquarePacking(const ObligatoryPartSizeOptions &opt, double p0, int branching, int fixed, SkylineMemo *memo,
+                  const SquareTable &t) :
+            Script(opt),
+            n(t.n),
+            p(p0),
+            symmetry(opt.symmetry()),
+            s(*this, fixed > 0 ? fixed : t.area, fixed > 0 ? fixed : t.stacked), //Problem decomposition, constraint min and max of s, s will be the first branching to enumerate subproblems.
+            xCoords(*this, n - 1, 0, fixed > 0 ? std::max(fixed - 2, 0) : t.stacked),//min coordinate = (0,0) max = (s,s). exclude 1x1 square
+            yCoords(*this, n - 1, 0, fixed > 0 ? std::max(fixed - 2, 0) : t.stacked)//min coordinate = (0,0) max = (s,s). exclude 1x1 square
+    {
+
+        /**
+         * Constraint on the origin coordinate of the squares.
+         * Square must be within enclosing square (s x s) (>= 0) and must not
+         * exceed x or y axis (<= s-size(i).
+         */
+        for (int i = 0; i < n - 1; ++i) {
+            if (fixed > 0) {
+                dom(*this, xCoords[i], 0, fixed - t.size[i]);
+                dom(*this, yCoords[i], 0, fixed - t.size[i]);
+            } else {
+                rel(*this, xCoords[i] >= 0);
+                rel(*this, xCoords[i] <= s - t.size[i]);
+                rel(*this, yCoords[i] >= 0);
+                rel(*this, yCoords[i] <= s - t.size[i]);
+            }
+        }
+
+        /**
+         * Apply constraints on coordinates that squares should not overlap (disjoint)
+         */
+        IntArgs w(n - 1, t.size);
+        IntArgs h(n - 1, t.size);
+        nooverlap(*this, xCoords, w, yCoords, h, noOverlapAlgorithm(opt.propagation()), opt.ipl());
+
+        /**
+         * Apply (cumulative) constraints of max sum(squareHeight) on columns and max sum(squareWidth) on rows.
+         * Redundant constraints to increase propagation, the non-overlapping coordinates implies this constraint.
+         * This redundant constraint have very big impact on performance.
+         */
+        occupancy(*this, xCoords, w, h, s, opt.ipl());
+        occupancy(*this, yCoords, h, w, s, opt.ipl());
+
+        /**
+         * Symmetry breaking. Restrict placement of the largest inside-square (n x n), implied by the lex-leader
+         * constraints but propagates before them
+         */
+        if (symmetry != SYMMETRY_NONE) {
+            if (fixed > 0)
+                rel(*this, xCoords[0], IRT_LQ, 1 + (fixed - n) / 2);
+            else
+                rel(*this, xCoords[0] <= 1 + (s - n) / 2);
+            rel(*this, yCoords[0] <= xCoords[0]);
+        }
+
+        if (symmetry == SYMMETRY_DIHEDRAL)
+            lexLeader(t);
+
+        /**
+         * Empty-strip dominance, gaps by square size from square_gaps.hpp (t.gap[i] is the gap of size
+         * t.size[i] = n - i, not of size i). Only with the largest square restriction: the dominance is not closed
+         * under the symmetries, so it would make the class sizes wrong. Square 0 is left out, moving it to the
+         * border could violate yCoords[0] <= xCoords[0]. Every other square is narrower than n, so the strip it
+         * leaves never contains square 0 and the move keeps the restriction.
+         */
+        for (int i = 1; (symmetry == SYMMETRY_LARGEST) && (i < n - 1); ++i) {
+            if (t.gap[i] >= 0) {
+                rel(*this, xCoords[i], IRT_NQ, t.gap[i]);
+                rel(*this, yCoords[i], IRT_NQ, t.gap[i]);
+            }
+            if (t.specific[i] >= 0)
+                rel(*this, yCoords[i], IRT_NQ, t.specific[i]);
         }
 
         /**
@@ -489,88 +2390,120 @@ public:
          */
         branch(*this, s, INT_VAL_MIN()); //Branch first on s
 
-        interval(*this, xCoords, w, p);
-        interval(*this, yCoords, w, p);
+        //Obligatory part percentage p for the largest square down to -obligatory-small for the smallest
+        double q = opt.obligatorySmall() > 0.0 ? opt.obligatorySmall() : p;
+        if (opt.model() == MODEL_INTERVAL_XY) {
+            interval(*this, xCoords, w, p, q);
+            interval(*this, yCoords, h, p, q);
+        } else {
+            interval(*this, xCoords, w, yCoords, h, p, q, opt.alternatives());
+        }
 
         //Try larger squares first, larger squares have smaller domains, try small x,y coords first (left-to-right, bottom-to-top)
-        branch(*this, xCoords, INT_VAR_SIZE_MIN(), INT_VAL_MIN()); //Assign x-coords first
-        branch(*this, yCoords, INT_VAR_SIZE_MIN(), INT_VAL_MIN()); //Assign y-coords second
+        if (branching == BRANCH_CORNER) {
+            //Assign x and y together, bottom-left first
+            corner(*this, xCoords, w, yCoords, h, s, memo);
+        } else if (opt.restart() == RM_NONE) {
+            branch(*this, xCoords, coordinateBranching(branching, opt.decay()), INT_VAL_MIN()); //Assign x-coords first
+            branch(*this, yCoords, coordinateBranching(branching, opt.decay()), INT_VAL_MIN()); //Assign y-coords second
+        } else {
+            //Break ties randomly, the generator is shared by all clones so every restart explores a different tree
+            //(restarts are only allowed with -solutions 1, see main)
+            Rnd r(opt.seed());
+            branch(*this, xCoords, tiebreak(coordinateBranching(branching, opt.decay()), INT_VAR_RND(r)), INT_VAL_MIN());
+            branch(*this, yCoords, tiebreak(coordinateBranching(branching, opt.decay()), INT_VAR_RND(r)), INT_VAL_MIN());
+        }
     }
 
-
     /**
-     * helper function
-     * @return square size of index i
+     * Lex-leader constraints for the symmetries of the enclosing square. Symmetry g maps the origin (x, y) of a square
+     * with m = s - size to (u, v) = (x, y), or (y, x) if g & 1, then u = m - u if g & 2 and v = m - v if g & 4.
+     * The packing read as y0 x0 y1 x1 ... must be lexicographically no larger than each of its 7 images, so exactly
+     * one packing per class remains (y first agrees with the restriction of the largest square).
      */
-    int size(int i) {
-        return n - i;
+    void lexLeader(const SquareTable &t) {
+        IntVarArgs rx(n - 1), ry(n - 1), v(2 * (n - 1));
+        for (int i = 0; i < n - 1; ++i) {
+            rx[i] = expr(*this, s - t.size[i] - xCoords[i]);
+            ry[i] = expr(*this, s - t.size[i] - yCoords[i]);
+            v[2 * i] = yCoords[i];
+            v[2 * i + 1] = xCoords[i];
+        }
+        for (int g = 1; g < 8; ++g) {
+            IntVarArgs image(2 * (n - 1));
+            for (int i = 0; i < n - 1; ++i) {
+                if (g & 1) {
+                    image[2 * i] = (g & 4) ? rx[i] : xCoords[i];
+                    image[2 * i + 1] = (g & 2) ? ry[i] : yCoords[i];
+                } else {
+                    image[2 * i] = (g & 4) ? ry[i] : yCoords[i];
+                    image[2 * i + 1] = (g & 2) ? rx[i] : xCoords[i];
+                }
+            }
+            rel(*this, v, IRT_LQ, image);
+        }
     }
 
-    /**
-     * Get the minimum area of n-squares
-     * @return
-     */
-    int nSquaresArea() {
-        return ceil(sqrt(n * (n + 1) * (2 * n + 1) / 6));
-    }
+public:
 
     /**
-     * Get the area to fit the n squares stacked on top of each other, i.e an upper bound on the size of s.
-     *
-     * @return
+     * Number of packings in the class of this solution under the 8 symmetries of the enclosing square (see
+     * lexLeader): 8 divided by the number of symmetries that map the packing onto itself.
+     * With -symmetry dihedral the class sizes of all solutions add up to the number of solutions with -symmetry none.
      */
-    int nSquaresStacked(int i) {
-        if (i == 0)
-            return 0;
-        return i + nSquaresStacked(i - 1);
+    int classSize(void) const {
+        int stabilizer = 0;
+        for (int g = 0; g < 8; ++g) {
+            bool same = true;
+            for (int i = 0; same && (i < n - 1); ++i) {
+                int m = s.val() - (n - i), x = xCoords[i].val(), y = yCoords[i].val();
+                int u = (g & 1) ? y : x, v = (g & 1) ? x : y;
+                if (g & 2)
+                    u = m - u;
+                if (g & 4)
+                    v = m - v;
+                same = (u == x) && (v == y);
+            }
+            if (same)
+                stabilizer++;
+        }
+        return 8 / stabilizer;
     }
 
     /**
-     * Prune variable domains with gaps where equivalent placement have already been investigated.
-     *
-     * @param i
-     * @return gap
+     * helper function
+     * @return variable selection for the -branching option
      */
-    int gap_generic(int i) {
-        if (i == 2)
-            return 2;
-        if (i == 3 || i == 4)
-            return 2;
-        if (i >= 5 && i <= 8)
-            return 3;
-        if (i >= 9 && i <= 11)
-            return 4;
-        if (i >= 12 && i <= 17)
-            return 5;
-        if (i >= 18 && i <= 21)
-            return 6;
-        if (i >= 22 && i <= 29)
-            return 7;
-        if (i >= 30 && i <= 34)
-            return 3;
-        if (i >= 34 && i <= 44)
-            return 9;
-        if (i == 45)
-            return 10;
-        return -1;
+    static IntVarBranch coordinateBranching(int branching, double decay) {
+        switch (branching) {
+            case BRANCH_AFC:
+                return INT_VAR_AFC_SIZE_MAX(decay);
+            case BRANCH_DEGREE:
+                return INT_VAR_DEGREE_MAX();
+            default:
+                return INT_VAR_SIZE_MIN();
+        }
     }
 
+
     /**
-     * Square-packing specific investigated gaps.
-     *
-     * @param i
-     * @return gap
+     * helper function
+     * @return no-overlap algorithm for the -propagation option
      */
-    int gap_specific(int i) {
-        if (i == 2)
-            return 2;
-        if (i == 3)
-            return 3;
-        return -1;
+    static NoOverlapAlgorithm noOverlapAlgorithm(int propagation) {
+        switch (propagation) {
+            case PROP_SWEEP:
+                return NOOVERLAP_SWEEP;
+            case PROP_INCREMENTAL:
+                return NOOVERLAP_INCREMENTAL;
+            default:
+                return NOOVERLAP_PAIRWISE;
+        }
     }
 
 /// Constructor for cloning
-    SquarePacking(bool share, SquarePacking &space) : Script(share, space), n(space.n), p(space.p) {
+    SquarePacking(bool share, SquarePacking &space) : Script(share, space), n(space.n), p(space.p),
+                                                      symmetry(space.symmetry) {
         s.update(*this, share, space.s);
         xCoords.update(*this, share, space.xCoords);
         yCoords.update(*this, share, space.yCoords);
@@ -591,10 +2524,1032 @@ public:
             os << "square" << n - i << ": (" << xCoords[i] << "," << yCoords[i] << ") ";
         }
         os << std::endl;
+        if ((symmetry == SYMMETRY_DIHEDRAL) && s.assigned() && xCoords.assigned() && yCoords.assigned())
+            os << "Symmetry class size: " << classSize() << std::endl;
+
+    }
+};
+
+/**
+ * Search probe for the presolve stage: search space below probe (ownership is taken) with at most limit nodes.
+ * @return true if the probe is proven to have no solution
+ */
+bool refuted(SquarePacking *probe, unsigned long int limit, Search::Statistics &statistics) {
+    Search::NodeStop stop(limit);
+    Search::Options so;
+    so.clone = false;
+    so.stop = &stop;
+    DFS<SquarePacking> e(probe, so);
+    SquarePacking *solution = e.next();
+    statistics += e.statistics();
+    delete solution;
+    return (solution == NULL) && !e.stopped();
+}
+
+/**
+ * Partition probe of s = v for the presolve stage: s = v is refuted if it is refuted as a whole within limit nodes
+ * or, failing that, if every x-position of the largest square is refuted within its own limit nodes. A fixed largest
+ * square lets the no-overlap and occupancy propagators cut the bands next to it, which the whole probe only reaches
+ * deep in its tree. split is set if only the partition refuted s = v.
+ * @return true if s = v is proven to have no solution
+ */
+bool refutedSize(SquarePacking &root, int v, unsigned long int limit, Search::Statistics &statistics, bool &split) {
+    split = false;
+    SquarePacking *probe = static_cast<SquarePacking *>(root.clone(false));
+    rel(*probe, probe->s == v);
+    if (probe->status() == SS_FAILED) {
+        delete probe;
+        return true;
+    }
+    SquarePacking *parts = static_cast<SquarePacking *>(probe->clone(false));
+    if (refuted(probe, limit, statistics)) {
+        delete parts;
+        return true;
+    }
+    //Without squares other than 1 x 1 there is nothing to split
+    bool all = parts->n > 1;
+    if (all)
+        for (IntVarValues x(parts->xCoords[0]); all && x(); ++x) {
+            SquarePacking *part = static_cast<SquarePacking *>(parts->clone(false));
+            rel(*part, part->xCoords[0] == x.val());
+            all = refuted(part, limit, statistics);
+        }
+    delete parts;
+    split = all;
+    return all;
+}
+
+// Total size of the coordinate domains of p
+unsigned long int coordinateValues(const SquarePacking &p) {
+    unsigned long int values = 0;
+    for (int i = 0; i < p.n - 1; ++i)
+        values += p.xCoords[i].size() + p.yCoords[i].size();
+    return values;
+}
+
+/**
+ * Build the model and tighten it before the main search (with -presolve limit, 0 = no presolve):
+ * - s >= SquareTable::lower, which also accounts for the two largest squares and not only the area.
+ * - Shave s from below: while s = s.min() is refuted within limit nodes, raise s.min(). A size the whole probe can
+ *   not refute is split by the position of the largest square (see refutedSize()).
+ * - Shave the bounds of the coordinates of the largest squares the same way, one value at a time.
+ * lowerBound() only beats the area bound up to n = 8. Static bounds for larger n (lattice bounds, the wasted
+ * space of the bands next to the one or two largest squares) were evaluated up to n = 59 and never exceed the area
+ * bound, since every other square fits into the bands next to the largest one. For those n the split probes are the
+ * bound that raises s.
+ * Prints what was tightened, the total size of the coordinate domains before and after, and how long the stage took
+ * to os.
+ * The time it saves the main search is not measured, that needs a second run with -presolve 0.
+ * @return model for the main search (possibly failed)
+ */
+SquarePacking *presolve(const ObligatoryPartSizeOptions &opt, std::ostream &os = std::cout, SkylineMemo *memo = NULL) {
+    SquarePacking *root = new SquarePacking(opt, memo);
+    if (opt.presolve() == 0)
+        return root;
+    Support::Timer timer;
+    timer.start();
+    Search::Statistics statistics;
+    if (root->status() == SS_FAILED)
+        return root;
+    const unsigned long int before = coordinateValues(*root);
+    const SquareTable t(root->n);
+    const int area = t.area, bound = t.lower;
+    rel(*root, root->s >= bound);
+    if (root->status() == SS_FAILED)
+        return root;
+
+    const int first = root->s.min();
+    int splits = 0;
+    while (!root->s.assigned()) {
+        bool split;
+        if (!refutedSize(*root, root->s.min(), opt.presolve(), statistics, split))
+            break;
+        if (split)
+            splits++;
+        rel(*root, root->s > root->s.min());
+        if (root->status() == SS_FAILED)
+            return root;
+    }
+
+    int values = 0;
+    for (int i = 0; i < std::min(4, root->n - 1); ++i)
+        for (int axis = 0; axis < 2; ++axis) {
+            IntVar v = axis == 0 ? root->xCoords[i] : root->yCoords[i];
+            for (int side = 0; (side < 2) && !v.assigned(); ++side)
+                while (!v.assigned()) {
+                    int value = side == 0 ? v.min() : v.max();
+                    SquarePacking *probe = static_cast<SquarePacking *>(root->clone(false));
+                    rel(*probe, (axis == 0 ? probe->xCoords[i] : probe->yCoords[i]) == value);
+                    if (!refuted(probe, opt.presolve(), statistics))
+                        break;
+                    rel(*root, v != value);
+                    values++;
+                    if (root->status() == SS_FAILED)
+                        return root;
+                }
+        }
+
+    //Propagate the shaved values before measuring
+    if (root->status() == SS_FAILED)
+        return root;
+    const unsigned long int after = coordinateValues(*root);
+    os << "Presolve: s >= " << root->s.min() << " (area bound " << area << ", lower bound " << bound
+       << ", " << root->s.min() - first << " sizes shaved, " << splits << " of them split by square " << root->n
+       << "), " << values << " coordinate values shaved" << std::endl
+       << "\tcoordinate domains: " << before << " -> " << after << " values ("
+       << (before > 0 ? (100.0 * (before - after)) / before : 0.0) << "% removed)" << std::endl
+       << "\tnodes: " << statistics.node << ", failures: " << statistics.fail << ", time: " << timer.stop()
+       << " ms (time saved: not measured, compare with -presolve 0)" << std::endl;
+    return root;
+}
+
+/**
+ * Stop object for the search of one enclosing size s: stops as soon as a smaller size has a solution.
+ */
+class SizeStop : public Search::Stop {
+protected:
+    // Smallest enclosing size with a solution so far
+    const std::atomic<int> &best;
+    // Enclosing size searched
+    const int s;
+public:
+    SizeStop(const std::atomic<int> &best0, int s0) : best(best0), s(s0) {}
+
+    virtual bool stop(const Search::Statistics &, const Search::Options &) {
+        return best.load() < s;
+    }
+};
+
+/**
+ * Outcome of the search for one enclosing size.
+ */
+struct SizeResult {
+    // First solution found, NULL if none
+    SquarePacking *first;
+    // Number of solutions found (at most opt.solutions(), all if 0), only the first one is kept
+    unsigned long int solutions;
+    // Search was stopped because a smaller size has a solution
+    bool cancelled;
+    // Search statistics and runtime in milliseconds
+    Search::Statistics statistics;
+    double time;
+
+    SizeResult(void) : first(NULL), solutions(0), cancelled(false), time(0.0) {}
+};
+
+/**
+ * Solve every candidate enclosing size s in [SquareTable::area, SquareTable::stacked] as its own subproblem on a pool of
+ * -threads worker threads (see threadCount()). Sizes are handed out smallest first. As soon as some size has a
+ * solution, all larger sizes are cancelled, while the smaller ones still run to completion, so the smallest size
+ * with a solution is optimal. Its first solution and one summary line per size are printed, further solutions (up to
+ * opt.solutions(), all if 0) are only counted so that memory does not grow with them.
+ * Every size gets its own model with s = v and exact coordinate domains (see SquarePacking), so clones are smaller
+ * than clones of the general root. The coordinate domains of the presolved root are copied into it, so the shaving
+ * of presolve() carries over. With -threads 1 the sizes are solved one after another.
+ */
+void solveSizesInParallel(const ObligatoryPartSizeOptions &opt) {
+    Support::Timer total;
+    total.start();
+
+    SquarePacking *root = presolve(opt);
+    if (root->status() == SS_FAILED) {
+        std::cout << "No solution" << std::endl;
+        delete root;
+        return;
+    }
+    const int lo = root->s.min();
+    const int count = root->s.max() - lo + 1;
+
+    unsigned int workers = threadCount(opt.threads());
+
+    std::vector<SizeResult> results(count);
+    std::atomic<int> best(root->s.max() + 1);
+    std::atomic<int> next(0);
+    //Presolved coordinate domains, read by all threads
+    std::vector<IntSet> xDomains, yDomains;
+    for (int i = 0; i < root->n - 1; ++i) {
+        IntVarRanges x(root->xCoords[i]), y(root->yCoords[i]);
+        xDomains.push_back(IntSet(x));
+        yDomains.push_back(IntSet(y));
+    }
+
+    std::vector<std::thread> pool;
+    for (unsigned int t = 0; t < std::min<unsigned int>(workers, count); ++t)
+        pool.push_back(std::thread([&]() {
+            for (int k = next++; k < count; k = next++) {
+                const int v = lo + k;
+                SizeResult &r = results[k];
+                if (best.load() < v) {
+                    r.cancelled = true;
+                    continue;
+                }
+                Support::Timer timer;
+                timer.start();
+                //Separate model for s = v with exact coordinate domains, narrowed to the presolved ones
+                SquarePacking *sub = new SquarePacking(opt, opt.obligatory(), opt.branching(), v);
+                for (int i = 0; i < sub->n - 1; ++i) {
+                    dom(*sub, sub->xCoords[i], xDomains[i]);
+                    dom(*sub, sub->yCoords[i], yDomains[i]);
+                }
+
+                SizeStop stop(best, v);
+                Search::Options so;
+                so.threads = 1;
+                so.c_d = opt.c_d();
+                so.a_d = opt.a_d();
+                so.clone = false;
+                so.stop = &stop;
+                DFS<SquarePacking> e(sub, so);
+                while (SquarePacking *solution = e.next()) {
+                    if (r.first == NULL)
+                        r.first = solution;
+                    else
+                        delete solution;
+                    //Record s as the best size, unless a smaller one is already known
+                    int b = best.load();
+                    while ((v < b) && !best.compare_exchange_weak(b, v));
+                    if ((++r.solutions >= opt.solutions()) && (opt.solutions() != 0))
+                        break;
+                }
+                r.cancelled = e.stopped();
+                r.statistics = e.statistics();
+                r.time = timer.stop();
+            }
+        }));
+    for (unsigned int t = 0; t < pool.size(); ++t)
+        pool[t].join();
+
+    //Smallest size with a solution, every smaller size has been searched completely
+    for (int k = 0; k < count; ++k)
+        if (results[k].first != NULL) {
+            results[k].first->print(std::cout);
+            break;
+        }
+
+    std::cout << std::endl << "Enclosing sizes (" << pool.size() << " threads):" << std::endl;
+    for (int k = 0; k < count; ++k) {
+        const SizeResult &r = results[k];
+        std::cout << "\ts = " << lo + k << ": ";
+        if (r.solutions > 0)
+            std::cout << r.solutions << " solution(s)";
+        else if (r.cancelled)
+            std::cout << "cancelled";
+        else
+            std::cout << "no solution";
+        std::cout << "\t" << r.time << " ms, nodes: " << r.statistics.node
+                  << ", failures: " << r.statistics.fail << std::endl;
+        delete r.first;
+    }
+    std::cout << "runtime: " << total.stop() << " ms" << std::endl;
+    delete root;
+}
+
+/**
+ * One configuration of a portfolio: obligatory part percentage and coordinate heuristic.
+ */
+struct PortfolioEntry {
+    double p;
+    int branching;
+    // Configuration as given on the command line
+    std::string name;
+};
+
+/**
+ * Parse the -portfolio list "p[:branching],..." where branching is size, afc or degree (default: -branching).
+ * @return false if some entry is malformed
+ */
+bool parsePortfolio(const ObligatoryPartSizeOptions &opt, std::vector<PortfolioEntry> &entries) {
+    std::stringstream list(opt.portfolio());
+    std::string item;
+    while (std::getline(list, item, ',')) {
+        if (item.empty())
+            continue;
+        PortfolioEntry e;
+        e.name = item;
+        e.branching = opt.branching();
+        std::string::size_type colon = item.find(':');
+        std::string heuristic = colon == std::string::npos ? "" : item.substr(colon + 1);
+        char *end;
+        std::string percentage = item.substr(0, colon);
+        e.p = std::strtod(percentage.c_str(), &end);
+        if ((*end != '\0') || (e.p <= 0.0) || (e.p > 1.0))
+            return false;
+        if (heuristic == "size")
+            e.branching = SquarePacking::BRANCH_SIZE;
+        else if (heuristic == "afc")
+            e.branching = SquarePacking::BRANCH_AFC;
+        else if (heuristic == "degree")
+            e.branching = SquarePacking::BRANCH_DEGREE;
+        else if (heuristic == "corner")
+            e.branching = SquarePacking::BRANCH_CORNER;
+        else if (!heuristic.empty())
+            return false;
+        entries.push_back(e);
+    }
+    return !entries.empty();
+}
+
+/**
+ * Stop object for a portfolio configuration: stops as soon as some configuration has finished.
+ */
+class PortfolioStop : public Search::Stop {
+protected:
+    // Index of the finished configuration, -1 while all are running
+    const std::atomic<int> &winner;
+public:
+    PortfolioStop(const std::atomic<int> &winner0) : winner(winner0) {}
+
+    virtual bool stop(const Search::Statistics &, const Search::Options &) {
+        return winner.load() >= 0;
+    }
+};
+
+/**
+ * Race the -portfolio configurations, one model and one DFS per configuration on its own thread. The first search
+ * to finish (opt.solutions() solutions found, all if 0, or search space exhausted) wins and all others are stopped.
+ * Prints the first solution and the number of solutions of the winner and which configuration won. Like
+ * solveSizesInParallel(), every configuration keeps only its first solution and counts the others, so memory does not
+ * grow with the number of solutions.
+ * @return false if -portfolio is malformed
+ */
+bool solvePortfolio(const ObligatoryPartSizeOptions &opt) {
+    std::vector<PortfolioEntry> entries;
+    if (!parsePortfolio(opt, entries)) {
+        std::cerr << "Error: malformed -portfolio \"" << opt.portfolio() << "\"" << std::endl;
+        return false;
+    }
+    const int k = static_cast<int>(entries.size());
+
+    Support::Timer total;
+    total.start();
+
+    std::atomic<int> winner(-1);
+    //First solution and number of solutions of every configuration
+    std::vector<SquarePacking *> first(k, NULL);
+    std::vector<unsigned long int> solutions(k, 0);
+    std::vector<Search::Statistics> statistics(k);
+
+    std::vector<std::thread> pool;
+    for (int c = 0; c < k; ++c)
+        pool.push_back(std::thread([&, c]() {
+            PortfolioStop stop(winner);
+            Search::Options so;
+            so.threads = 1;
+            so.c_d = opt.c_d();
+            so.a_d = opt.a_d();
+            so.clone = false;
+            so.stop = &stop;
+            DFS<SquarePacking> e(new SquarePacking(opt, entries[c].p, entries[c].branching), so);
+            while (SquarePacking *solution = e.next()) {
+                if (first[c] == NULL)
+                    first[c] = solution;
+                else
+                    delete solution;
+                if ((++solutions[c] >= opt.solutions()) && (opt.solutions() != 0))
+                    break;
+            }
+            //Only a search that was not stopped has an answer
+            int none = -1;
+            if (!e.stopped())
+                winner.compare_exchange_strong(none, c);
+            statistics[c] = e.statistics();
+        }));
+    for (int c = 0; c < k; ++c)
+        pool[c].join();
+
+    const int w = winner.load();
+    if (w >= 0) {
+        if (first[w] != NULL)
+            first[w]->print(std::cout);
+        else
+            std::cout << "No solution" << std::endl;
+    }
+
+    std::cout << std::endl << "Portfolio (" << k << " configurations):" << std::endl;
+    for (int c = 0; c < k; ++c) {
+        std::cout << (c == w ? "\t* " : "\t  ") << entries[c].name << " (p = " << entries[c].p << "): "
+                  << solutions[c] << " solution(s), nodes: " << statistics[c].node << ", failures: "
+                  << statistics[c].fail << std::endl;
+        delete first[c];
+    }
+    if (w >= 0)
+        std::cout << "winner: " << entries[w].name << std::endl;
+    std::cout << "runtime: " << total.stop() << " ms" << std::endl;
+    return true;
+}
+
+/**
+ * Write all n bytes of data to file descriptor fd, retrying after signals.
+ * @return false if the other end is gone (SIGPIPE is ignored by solveInProcesses())
+ */
+bool writeAll(int fd, const void *data, size_t n) {
+    const char *c = static_cast<const char *>(data);
+    while (n > 0) {
+        ssize_t k = write(fd, c, n);
+        if ((k < 0) && (errno == EINTR))
+            continue;
+        if (k <= 0)
+            return false;
+        c += k;
+        n -= k;
+    }
+    return true;
+}
+
+/**
+ * Read exactly n bytes from file descriptor fd into data, retrying after signals.
+ * @return false if the other end is gone
+ */
+bool readAll(int fd, void *data, size_t n) {
+    char *c = static_cast<char *>(data);
+    while (n > 0) {
+        ssize_t k = read(fd, c, n);
+        if ((k < 0) && (errno == EINTR))
+            continue;
+        if (k <= 0)
+            return false;
+        c += k;
+        n -= k;
+    }
+    return true;
+}
+
+// Length prefixed array of words, the empty message tells a worker to exit
+bool sendWords(int fd, const std::vector<unsigned int> &m) {
+    unsigned int n = m.size();
+    return writeAll(fd, &n, sizeof(n)) && ((n == 0) || writeAll(fd, &m[0], n * sizeof(unsigned int)));
+}
+
+bool receiveWords(int fd, std::vector<unsigned int> &m) {
+    unsigned int n;
+    if (!readAll(fd, &n, sizeof(n)))
+        return false;
+    m.resize(n);
+    return (n == 0) || readAll(fd, &m[0], n * sizeof(unsigned int));
+}
+
+/**
+ * Result of searching one subtree. A worker sends every printed solution as soon as it is found (length, then the
+ * text) and ends the subtree with length 0 followed by the report.
+ */
+struct WorkReport {
+    unsigned long int node;
+    unsigned long int fail;
+};
+
+/**
+ * Rebuild the node of the search tree reached from root by path. A path is a sequence of steps
+ * (alternative, archive size, archived choice...), as produced by the coordinator of solveInProcesses().
+ * @return node (possibly failed), owned by the caller
+ */
+SquarePacking *replay(const SquarePacking &root, const std::vector<unsigned int> &path, unsigned int from) {
+    SquarePacking *node = static_cast<SquarePacking *>(root.clone(false));
+    for (unsigned int i = from; i < path.size();) {
+        unsigned int alternative = path[i], size = path[i + 1];
+        Archive e;
+        for (unsigned int j = 0; j < size; ++j)
+            e << path[i + 2 + j];
+        i += 2 + size;
+        if (node->status() == SS_FAILED)
+            break;
+        const Choice *c = node->choice(e);
+        node->commit(*c, alternative);
+        delete c;
+    }
+    return node;
+}
+
+/**
+ * Worker process: receive paths (preceded by the solution limit, 0 = all), search the subtree below each with DFS
+ * and send its printed solutions and statistics (see WorkReport), until the empty message arrives.
+ */
+void worker(const SquarePacking &root, const ObligatoryPartSizeOptions &opt, int in, int out) {
+    std::vector<unsigned int> message;
+    while (receiveWords(in, message) && !message.empty()) {
+        const unsigned int limit = message[0];
+        Search::Options so;
+        so.threads = 1;
+        so.c_d = opt.c_d();
+        so.a_d = opt.a_d();
+        so.clone = false;
+        DFS<SquarePacking> e(replay(root, message, 1), so);
+        unsigned int found = 0;
+        while (SquarePacking *solution = e.next()) {
+            std::ostringstream os;
+            solution->print(os);
+            delete solution;
+            std::string printed = os.str();
+            unsigned int n = printed.size();
+            if (!writeAll(out, &n, sizeof(n)) || !writeAll(out, printed.data(), n))
+                return;
+            if ((++found >= limit) && (limit != 0))
+                break;
+        }
+        unsigned int end = 0;
+        WorkReport report;
+        report.node = e.statistics().node;
+        report.fail = e.statistics().fail;
+        if (!writeAll(out, &end, sizeof(end)) || !writeAll(out, &report, sizeof(report)))
+            return;
+    }
+}
+
+/**
+ * Open node of the search tree while splitting work: its path from the root and the space itself.
+ */
+struct OpenNode {
+    std::vector<unsigned int> path;
+    SquarePacking *space;
+};
+
+/**
+ * Terminate and reap the started workers, entries <= 0 are workers that were never forked
+ */
+void stopWorkers(const std::vector<pid_t> &pids) {
+    for (unsigned int w = 0; w < pids.size(); ++w)
+        if (pids[w] > 0) {
+            kill(pids[w], SIGTERM);
+            waitpid(pids[w], NULL, 0);
+        }
+}
+
+/**
+ * Stop all workers and exit, after a worker died or a pipe broke
+ */
+void abandonWorkers(const std::vector<pid_t> &pids, pid_t dead) {
+    std::cerr << "Error: worker " << dead << " died" << std::endl;
+    stopWorkers(pids);
+    std::exit(EXIT_FAILURE);
+}
+
+/**
+ * Distribute the search over -threads worker processes (see threadCount()) forked from this one.
+ * The coordinator expands the top of the search tree breadth-first until there are several subtrees per worker,
+ * then hands the subtrees out to idle workers in left-to-right order as archived paths over pipes.
+ * With a solution limit, solutions are reported in the order of a sequential DFS: a subtree's solutions (at most
+ * the limit) are only printed once all subtrees left of it are finished, and the search ends as soon as that prefix
+ * holds opt.solutions() solutions. With opt.solutions() = 0 every solution is printed as soon as it arrives.
+ */
+void solveInProcesses(const ObligatoryPartSizeOptions &opt) {
+    Support::Timer total;
+    total.start();
+
+    SquarePacking *root = presolve(opt);
+    if (root->status() == SS_FAILED) {
+        std::cout << "No solution" << std::endl;
+        delete root;
+        return;
+    }
+    unsigned int workers = threadCount(opt.threads());
+
+    //Expand level by level, keeping the subtrees in left-to-right order
+    std::vector<OpenNode> frontier(1);
+    frontier[0].space = static_cast<SquarePacking *>(root->clone(false));
+    for (bool expanded = true; expanded && (frontier.size() < 8 * workers);) {
+        expanded = false;
+        std::vector<OpenNode> next;
+        for (unsigned int i = 0; i < frontier.size(); ++i) {
+            OpenNode &node = frontier[i];
+            SpaceStatus status = node.space->status();
+            if (status == SS_FAILED) {
+                delete node.space;
+                continue;
+            }
+            if (status == SS_SOLVED) {
+                next.push_back(node);
+                continue;
+            }
+            const Choice *c = node.space->choice();
+            Archive e;
+            c->archive(e);
+            for (unsigned int a = 0; a < c->alternatives(); ++a) {
+                OpenNode child;
+                child.path = node.path;
+                child.path.push_back(a);
+                child.path.push_back(e.size());
+                for (int j = 0; j < e.size(); ++j)
+                    child.path.push_back(e[j]);
+                child.space = static_cast<SquarePacking *>(node.space->clone(false));
+                child.space->commit(*c, a);
+                next.push_back(child);
+            }
+            delete c;
+            delete node.space;
+            expanded = true;
+        }
+        frontier.swap(next);
+    }
+    for (unsigned int i = 0; i < frontier.size(); ++i)
+        delete frontier[i].space;
+    const unsigned int count = frontier.size();
+    workers = std::max(1u, std::min(workers, count));
+
+    //Fork the workers, each gets the root space and a pipe in each direction
+    //A write to a dead worker must fail with EPIPE instead of killing the coordinator
+    signal(SIGPIPE, SIG_IGN);
+    std::vector<pid_t> pids(workers, -1);
+    std::vector<int> toWorker(workers), fromWorker(workers);
+    for (unsigned int w = 0; w < workers; ++w) {
+        int down[2], up[2];
+        if ((pipe(down) != 0) || (pipe(up) != 0)) {
+            std::cerr << "Error: cannot create pipes" << std::endl;
+            stopWorkers(pids);
+            std::exit(EXIT_FAILURE);
+        }
+        pids[w] = fork();
+        if (pids[w] < 0) {
+            std::cerr << "Error: cannot fork worker " << w << std::endl;
+            stopWorkers(pids);
+            std::exit(EXIT_FAILURE);
+        }
+        if (pids[w] == 0) {
+            close(down[1]);
+            close(up[0]);
+            for (unsigned int v = 0; v < w; ++v) {
+                close(toWorker[v]);
+                close(fromWorker[v]);
+            }
+            worker(*root, opt, down[0], up[1]);
+            _exit(EXIT_SUCCESS);
+        }
+        close(down[0]);
+        close(up[1]);
+        toWorker[w] = down[1];
+        fromWorker[w] = up[0];
+    }
+
+    //Hand out subtrees and collect reports
+    std::vector<bool> finished(count, false);
+    std::vector<std::vector<std::string> > printed(count);
+    std::vector<int> task(workers, -1);
+    unsigned long int nodes = 0, failures = 0;
+    unsigned int next = 0, prefix = 0, found = 0;
+    bool done = false;
+    while (!done) {
+        for (unsigned int w = 0; w < workers; ++w)
+            if ((task[w] < 0) && (next < count)) {
+                std::vector<unsigned int> message(1, opt.solutions());
+                message.insert(message.end(), frontier[next].path.begin(), frontier[next].path.end());
+                if (!sendWords(toWorker[w], message))
+                    abandonWorkers(pids, pids[w]);
+                task[w] = next++;
+            }
+        std::vector<pollfd> fds;
+        std::vector<unsigned int> owner;
+        for (unsigned int w = 0; w < workers; ++w)
+            if (task[w] >= 0) {
+                pollfd p = {fromWorker[w], POLLIN, 0};
+                fds.push_back(p);
+                owner.push_back(w);
+            }
+        if (fds.empty())
+            break;
+        if ((poll(&fds[0], fds.size(), -1) < 0) && (errno != EINTR)) {
+            std::cerr << "Error: cannot wait for the workers" << std::endl;
+            stopWorkers(pids);
+            std::exit(EXIT_FAILURE);
+        }
+        for (unsigned int f = 0; f < fds.size(); ++f) {
+            if (fds[f].revents == 0)
+                continue;
+            //One message per poll: a solution, or the end of the subtree with its report
+            const unsigned int w = owner[f];
+            unsigned int n;
+            if (!readAll(fromWorker[w], &n, sizeof(n)))
+                abandonWorkers(pids, pids[w]);
+            if (n > 0) {
+                std::string text(n, ' ');
+                if (!readAll(fromWorker[w], &text[0], n))
+                    abandonWorkers(pids, pids[w]);
+                if (opt.solutions() == 0) {
+                    std::cout << text;
+                    found++;
+                } else {
+                    printed[task[w]].push_back(text);
+                }
+                continue;
+            }
+            WorkReport report;
+            if (!readAll(fromWorker[w], &report, sizeof(report)))
+                abandonWorkers(pids, pids[w]);
+            nodes += report.node;
+            failures += report.fail;
+            finished[task[w]] = true;
+            task[w] = -1;
+        }
+        //Solutions of the finished prefix, in sequential DFS order
+        for (; (prefix < count) && finished[prefix]; ++prefix) {
+            for (unsigned int i = 0; (i < printed[prefix].size()) && (found < opt.solutions()); ++i) {
+                std::cout << printed[prefix][i];
+                found++;
+            }
+            printed[prefix].clear();
+        }
+        done = (prefix == count) || ((opt.solutions() != 0) && (found >= opt.solutions()));
+    }
+
+    //Stop the workers, busy ones are still searching subtrees whose solutions are not needed
+    for (unsigned int w = 0; w < workers; ++w) {
+        if (task[w] >= 0)
+            kill(pids[w], SIGTERM);
+        else
+            sendWords(toWorker[w], std::vector<unsigned int>());
+        close(toWorker[w]);
+        close(fromWorker[w]);
+        waitpid(pids[w], NULL, 0);
+    }
+    if (found == 0)
+        std::cout << "No solution" << std::endl;
+    std::cout << std::endl << "Subtrees: " << count << " on " << workers << " processes" << std::endl
+              << "nodes: " << nodes << ", failures: " << failures << " (finished subtrees)" << std::endl
+              << "runtime: " << total.stop() << " ms" << std::endl;
+    delete root;
+}
+
+/**
+ * Stop object for one dimension of a sweep: the -node and -time limits of the options (0 = none).
+ */
+class SweepStop : public Search::Stop {
+protected:
+    unsigned long int node;
+    double time;
+    Support::Timer timer;
+public:
+    SweepStop(unsigned long int node0, double time0) : node(node0), time(time0) {
+        timer.start();
+    }
+
+    virtual bool stop(const Search::Statistics &s, const Search::Options &) {
+        return ((node > 0) && (s.node > node)) || ((time > 0) && (timer.stop() > time));
+    }
+};
+
+/**
+ * Optimal enclosing size of one dimension with the statistics of the run that proved it.
+ */
+struct SweepResult {
+    int s;
+    unsigned long int node, fail;
+    double time;
+};
+
+/**
+ * Solve the dimensions -dimension ... -sweep one after another for the smallest enclosing size.
+ * A packing of the squares 1 ... n + 1 contains one of 1 ... n, so the optimum of n is a lower bound for n + 1 and is
+ * posted before the search of n + 1 starts (besides SquareTable::lower). A dimension stopped by -node or -time
+ * keeps the bound it started with. Proven optima are appended to the -cache file (if given) and read back by later
+ * sweeps, which skip those dimensions.
+ * @return false if the -cache file cannot be written
+ */
+bool sweep(ObligatoryPartSizeOptions &opt) {
+    std::map<int, SweepResult> cache;
+    if (opt.cache() != NULL) {
+        std::ifstream in(opt.cache());
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.empty() || (line[0] == '#'))
+                continue;
+            std::istringstream fields(line);
+            int n;
+            SweepResult r;
+            if (fields >> n >> r.s >> r.node >> r.fail >> r.time)
+                cache[n] = r;
+        }
+    }
+    std::ofstream out;
+    if (opt.cache() != NULL) {
+        bool fresh = cache.empty();
+        out.open(opt.cache(), std::ios::app);
+        if (fresh)
+            out << "# n s nodes failures time(ms)" << std::endl;
+        //Fail before hours of search whose results could not be kept
+        if (!out) {
+            std::cerr << "Error: cannot write -cache " << opt.cache() << std::endl;
+            return false;
+        }
+    }
+
+    Support::Timer total;
+    total.start();
+    const int first = opt.dimension(), last = opt.sweep();
+    int bound = 0;
+    for (int n = first; n <= last; ++n) {
+        opt.dimension(n);
+        std::map<int, SweepResult>::const_iterator c = cache.find(n);
+        if (c != cache.end()) {
+            bound = c->second.s;
+            std::cout << "n = " << n << ": s = " << bound << " (cached, nodes: " << c->second.node
+                      << ", failures: " << c->second.fail << ", " << c->second.time << " ms)" << std::endl;
+            continue;
+        }
+
+        Support::Timer timer;
+        timer.start();
+        SquarePacking *root = presolve(opt);
+        const int lower = std::max(bound, SquareTable(n).lower);
+        rel(*root, root->s >= lower);
+
+        SweepStop stop(opt.node(), opt.time());
+        Search::Options so;
+        so.c_d = opt.c_d();
+        so.a_d = opt.a_d();
+        so.clone = false;
+        so.stop = &stop;
+        DFS<SquarePacking> e(root, so);
+        //s is branched on first with the smallest value, so the first solution is optimal
+        SquarePacking *solution = e.next();
+        SweepResult r;
+        r.node = e.statistics().node;
+        r.fail = e.statistics().fail;
+        r.time = timer.stop();
+        std::cout << "n = " << n << ": ";
+        if (solution != NULL) {
+            r.s = solution->s.val();
+            bound = r.s;
+            cache[n] = r;
+            if (out.is_open() && !(out << n << " " << r.s << " " << r.node << " " << r.fail << " " << r.time << std::endl)) {
+                std::cerr << "Error: cannot write -cache " << opt.cache() << std::endl;
+                delete solution;
+                return false;
+            }
+            std::cout << "s = " << r.s;
+        } else if (e.stopped()) {
+            bound = lower;
+            std::cout << "stopped, s >= " << lower;
+        } else {
+            std::cout << "no solution";
+        }
+        std::cout << " (lower bound " << lower << ", nodes: " << r.node << ", failures: " << r.fail << ", "
+                  << r.time << " ms)" << std::endl;
+        //No enclosing size at all, the model does not admit this dimension
+        bool infeasible = (solution == NULL) && !e.stopped();
+        delete solution;
+        if (infeasible)
+            break;
+    }
+    std::cout << "runtime: " << total.stop() << " ms" << std::endl;
+    return true;
+}
+
+/**
+ * Buffered writer of solution records for the -sink modes. Text records are one line per solution
+ * "s x0 y0 x1 y1 ..." (squares n ... 2), binary records are the same numbers as fixed-width native 32-bit integers
+ * (1 + 2 * (n - 1) per solution). With -symmetry dihedral every record ends with the class size of the packing.
+ * Numbers are formatted by hand and written in large blocks, so enumeration is not bounded by stream formatting.
+ */
+class SolutionSink {
+protected:
+    FILE *file;
+    bool binary;
+    std::vector<char> buffer;
+    size_t used;
+
+    void write(const void *data, size_t n) {
+        if (used + n > buffer.size())
+            flush();
+        std::memcpy(&buffer[used], data, n);
+        used += n;
+    }
+
+    void text(int v, char end) {
+        char digits[12];
+        int k = sizeof(digits);
+        digits[--k] = end;
+        unsigned int u = v < 0 ? -v : v;
+        do {
+            digits[--k] = static_cast<char>('0' + u % 10);
+            u /= 10;
+        } while (u > 0);
+        if (v < 0)
+            digits[--k] = '-';
+        write(digits + k, sizeof(digits) - k);
+    }
+
+    void put(int v, char end) {
+        if (binary) {
+            int32_t w = v;
+            write(&w, sizeof(w));
+        } else {
+            text(v, end);
+        }
+    }
+
+public:
+    SolutionSink(FILE *file0, bool binary0) : file(file0), binary(binary0), buffer(1 << 20), used(0) {}
+
+    ~SolutionSink(void) {
+        flush();
+    }
 
+    void put(const SquarePacking &solution) {
+        bool classes = solution.symmetry == SquarePacking::SYMMETRY_DIHEDRAL;
+        put(solution.s.val(), ' ');
+        for (int i = 0; i < solution.n - 1; ++i) {
+            put(solution.xCoords[i].val(), ' ');
+            put(solution.yCoords[i].val(), classes || (i + 2 < solution.n) ? ' ' : '\n');
+        }
+        if (classes)
+            put(solution.classSize(), '\n');
+    }
+
+    void flush(void) {
+        if (used > 0)
+            fwrite(&buffer[0], 1, used, file);
+        used = 0;
+        fflush(file);
     }
 };
 
+/**
+ * Enumerate solutions (opt.solutions(), all if 0) without SquarePacking::print: -sink count only counts them,
+ * -sink text and -sink binary stream records through a SolutionSink to -output (standard output if not given).
+ * With -symmetry dihedral the summary also gives the number of packings the canonical solutions stand for.
+ * The summary (and the presolve report) goes to standard error when the records go to standard output.
+ * @return false if -output cannot be opened
+ */
+bool enumerate(const ObligatoryPartSizeOptions &opt) {
+    FILE *file = stdout;
+    if ((opt.sink() != SquarePacking::SINK_COUNT) && (opt.output() != NULL)) {
+        file = fopen(opt.output(), opt.sink() == SquarePacking::SINK_BINARY ? "wb" : "w");
+        if (file == NULL) {
+            std::cerr << "Error: cannot open " << opt.output() << std::endl;
+            return false;
+        }
+    }
+    std::ostream &summary = (opt.sink() != SquarePacking::SINK_COUNT) && (file == stdout) ? std::cerr : std::cout;
+
+    Support::Timer timer;
+    timer.start();
+    unsigned long int count = 0, packings = 0;
+    Search::Statistics statistics;
+    bool stopped;
+    {
+        SolutionSink sink(file, opt.sink() == SquarePacking::SINK_BINARY);
+        SweepStop stop(opt.node(), opt.time());
+        Search::Options so;
+        so.threads = opt.threads();
+        so.c_d = opt.c_d();
+        so.a_d = opt.a_d();
+        so.clone = false;
+        so.stop = &stop;
+        DFS<SquarePacking> e(presolve(opt, summary), so);
+        while (SquarePacking *solution = e.next()) {
+            if (opt.sink() != SquarePacking::SINK_COUNT)
+                sink.put(*solution);
+            packings += solution->symmetry == SquarePacking::SYMMETRY_DIHEDRAL ? solution->classSize() : 1;
+            delete solution;
+            if ((++count == opt.solutions()) && (opt.solutions() != 0))
+                break;
+        }
+        statistics = e.statistics();
+        stopped = e.stopped();
+    }
+    if (file != stdout)
+        fclose(file);
+    summary << "solutions: " << count << (stopped ? " (search stopped)" : "") << std::endl;
+    if (opt.symmetry() == SquarePacking::SYMMETRY_DIHEDRAL)
+        summary << "packings (sum of class sizes): " << packings << std::endl;
+    summary
+            << "nodes: " << statistics.node << ", failures: " << statistics.fail << std::endl
+            << "runtime: " << timer.stop() << " ms" << std::endl;
+    return true;
+}
+
+/**
+ * Sequential DFS with the failed packing memo of -memo. The memo learns that a subtree failed from the order in which
+ * DFS visits the nodes and must be told about every solution, so this runs its own engine loop instead of the Gecode
+ * driver: solutions are printed as they are found (opt.solutions(), all if 0), followed by the statistics.
+ * The memo is only enabled after presolve(), whose probe searches must not record anything.
+ */
+void solveWithMemo(const ObligatoryPartSizeOptions &opt) {
+    Support::Timer timer;
+    timer.start();
+    SkylineMemo memo;
+    SquarePacking *root = presolve(opt, std::cout, &memo);
+    memo.resize(opt.memo());
+    SweepStop stop(opt.node(), opt.time());
+    Search::Options so;
+    so.threads = 1;
+    so.c_d = opt.c_d();
+    so.a_d = opt.a_d();
+    so.clone = false;
+    so.stop = &stop;
+    DFS<SquarePacking> e(root, so);
+    unsigned long int count = 0;
+    while (SquarePacking *solution = e.next()) {
+        memo.solution();
+        solution->print(std::cout);
+        delete solution;
+        if ((++count == opt.solutions()) && (opt.solutions() != 0))
+            break;
+    }
+    Search::Statistics statistics = e.statistics();
+    std::cout << std::endl << "solutions: " << count << (e.stopped() ? " (search stopped)" : "") << std::endl
+              << "nodes: " << statistics.node << ", failures: " << statistics.fail << std::endl
+              << "runtime: " << timer.stop() << " ms" << std::endl;
+    memo.print(std::cout);
+}
+
 /**
  * Program entrypoint, parses commandline options and initializes search engine with root-node.
  * @param argc
@@ -611,15 +3566,112 @@ int main(int argc, char *argv[]) {
     opt.iterations(100); //how many iterations before measuring runtime
     //opt.size(10); //n size
     opt.mode(ScriptMode::SM_SOLUTION); //Solution mode (i.e no GIST) is default
-    opt.ipl(IPL_DEF); //Default propagation strength
+    opt.ipl(IPL_DEF); //Default propagation strength, dom adds energetic reasoning to the no-overlap constraint
+    opt.propagation(SquarePacking::PROP_PAIRWISE); //Default no-overlap propagator
+    opt.propagation(SquarePacking::PROP_PAIRWISE, "pairwise", "check all pairs of squares (quadratic)");
+    opt.propagation(SquarePacking::PROP_SWEEP, "sweep", "sweep over compulsory parts (n log n)");
+    opt.propagation(SquarePacking::PROP_INCREMENTAL, "incremental", "only revisit squares changed since last run");
+    opt.search(SquarePacking::SEARCH_DFS); //Default search
+    opt.search(SquarePacking::SEARCH_DFS, "dfs", "one DFS over all enclosing sizes");
+    opt.search(SquarePacking::SEARCH_PARALLEL_S, "parallel-s", "one DFS per enclosing size on -threads threads");
+    opt.search(SquarePacking::SEARCH_PROCESSES, "processes", "subtrees distributed to -threads worker processes");
+    opt.restart(RM_NONE); //Plain DFS by default, -restart luby|geometric|... for restart-based search
+    opt.restart_base(1.5); //Base for geometric restarts
+    opt.restart_scale(250); //Failures per restart unit
+    opt.nogoods(true); //Post nogoods from the DFS frontier of each restart (only used with -restart)
+    opt.model(SquarePacking::MODEL_INTERVAL_XY); //Default interval branching
+    opt.model(SquarePacking::MODEL_INTERVAL_2D, "interval-2d", "one interval brancher over x and y, tightest coordinate first");
+    opt.model(SquarePacking::MODEL_INTERVAL_XY, "interval-xy", "interval branching over all x, then over all y");
+    opt.branching(SquarePacking::BRANCH_SIZE); //Default coordinate heuristic
+    opt.branching(SquarePacking::BRANCH_SIZE, "size", "smallest coordinate domain first");
+    opt.branching(SquarePacking::BRANCH_AFC, "afc", "largest accumulated failure count / domain size first");
+    opt.branching(SquarePacking::BRANCH_DEGREE, "degree", "largest degree first");
+    opt.branching(SquarePacking::BRANCH_CORNER, "corner", "place squares at the bottom-left free cell");
+    opt.symmetry(SquarePacking::SYMMETRY_LARGEST); //Default symmetry breaking
+    opt.symmetry(SquarePacking::SYMMETRY_LARGEST, "largest", "largest square in one eighth of the enclosing square, empty-strip dominance");
+    opt.symmetry(SquarePacking::SYMMETRY_NONE, "none", "no symmetry breaking or dominance, every packing is a solution");
+    opt.symmetry(SquarePacking::SYMMETRY_DIHEDRAL, "dihedral", "one lex-leader packing per class of the 8 symmetries, with its class size");
     opt.parse(argc, argv);
 
 
     //parse cmd (potentially overwrite default options)
     opt.parse(argc, argv);
 
+    if ((opt.model() == SquarePacking::MODEL_INTERVAL_XY) && (opt.alternatives() != 2)) {
+        //interval-xy always splits in two
+        std::cerr << "Error: -alternatives needs -model interval-2d" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    //-sink, -sweep, -portfolio and -search parallel-s|processes each run their own driver, so at most one of them
+    if (((opt.sink() != SquarePacking::SINK_PRINT) ? 1 : 0) + ((opt.sweep() > 0) ? 1 : 0) +
+        ((opt.portfolio() != NULL) ? 1 : 0) + ((opt.search() != SquarePacking::SEARCH_DFS) ? 1 : 0) > 1) {
+        std::cerr << "Error: -sink, -sweep, -portfolio and -search parallel-s|processes can not be combined" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if ((opt.portfolio() != NULL) && (opt.presolve() > 0)) {
+        //every configuration builds its own model, none of them is presolved
+        std::cerr << "Error: -portfolio works without -presolve" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (opt.restart() != RM_NONE) {
+        //RBS restarts after every solution and SquarePacking does not constrain later solutions, so every restart
+        //could find the same packing again: only the first solution is well defined. Only the plain run uses RBS,
+        //the other drivers and the presolve probes build plain DFS engines
+        if ((opt.solutions() != 1) || (opt.sink() != SquarePacking::SINK_PRINT) || (opt.sweep() > 0) ||
+            (opt.portfolio() != NULL) || (opt.search() != SquarePacking::SEARCH_DFS) || (opt.presolve() > 0)) {
+            std::cerr << "Error: -restart needs -solutions 1 and -search dfs, and works without -sink, -sweep, "
+                      << "-portfolio and -presolve" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (opt.memo() > 0) {
+        //the memo relies on the node order of one sequential DFS over corner-point branching, see solveWithMemo()
+        //a failure under lex-leader constraints depends on the placement, not only on the covered cells
+        if ((opt.branching() != SquarePacking::BRANCH_CORNER) || (opt.restart() != RM_NONE) || (opt.threads() != 1) ||
+            (opt.mode() == SM_GIST) || (opt.symmetry() == SquarePacking::SYMMETRY_DIHEDRAL) ||
+            (opt.search() != SquarePacking::SEARCH_DFS) || (opt.sink() != SquarePacking::SINK_PRINT) ||
+            (opt.sweep() > 0) || (opt.portfolio() != NULL)) {
+            std::cerr << "Error: -memo needs -branching corner, -threads 1 and -search dfs, and works without "
+                      << "restarts, gist, -symmetry dihedral, -sink, -sweep and -portfolio" << std::endl;
+            return EXIT_FAILURE;
+        }
+        solveWithMemo(opt);
+        return 0;
+    }
+
+    if (opt.sink() != SquarePacking::SINK_PRINT) {
+        //count or stream solutions without print()
+        return enumerate(opt) ? 0 : EXIT_FAILURE;
+    }
+
+    if (opt.sweep() > 0) {
+        //solve a range of dimensions, each starting from the bound of the previous one
+        return sweep(opt) ? 0 : EXIT_FAILURE;
+    }
+
+    if (opt.portfolio() != NULL) {
+        //race the configurations given with -portfolio
+        return solvePortfolio(opt) ? 0 : EXIT_FAILURE;
+    }
+
+    if (opt.search() == SquarePacking::SEARCH_PROCESSES) {
+        //distribute subtrees to worker processes
+        solveInProcesses(opt);
+        return 0;
+    }
+
+    if (opt.search() == SquarePacking::SEARCH_PARALLEL_S) {
+        //solve the enclosing sizes concurrently
+        solveSizesInParallel(opt);
+        return 0;
+    }
+
     //run script with DFS engine
-    Script::run<SquarePacking, DFS, ObligatoryPartSizeOptions>(opt);
+    Script::run<SquarePacking, DFS, ObligatoryPartSizeOptions>(opt, presolve(opt));
 
     /**
      * Example cmd to solve:
@@ -627,6 +3679,20 @@ int main(int argc, char *argv[]) {
      * ./bin/square_packing_with_overlap_and_interval -mode solution -ipl speed -solutions 0 -dimension 3 -obligatory 0.35
      * ./bin/square_packing_with_overlap_and_interval -mode time -ipl def -solutions 0 -dimension 3 -obligatory 0.35
      * ./bin/square_packing_with_overlap_and_interval -mode stat -ipl memory -solutions 0 -dimension 3 -obligatory 0.35
+     * ./bin/square_packing_with_overlap_and_interval -mode stat -propagation sweep -solutions 1 -dimension 30 -obligatory 0.35
+     * ./bin/square_packing_with_overlap_and_interval -search parallel-s -threads 0 -solutions 1 -dimension 25 -obligatory 0.35
+     * ./bin/square_packing_with_overlap_and_interval -obligatory 0.5 -obligatory-small 0.2 -solutions 1 -dimension 25
+     * ./bin/square_packing_with_overlap_and_interval -model interval-2d -alternatives 3 -obligatory 0.5 -obligatory-small 0.2 -solutions 1 -dimension 25
+     * ./bin/square_packing_with_overlap_and_interval -restart luby -restart_scale 250 -nogoods true -seed 7 -solutions 1 -dimension 25
+     * ./bin/square_packing_with_overlap_and_interval -branching corner -solutions 1 -dimension 25
+     * ./bin/square_packing_with_overlap_and_interval -mode stat -branching corner -memo 100000 -solutions 1 -dimension 25
+     * ./bin/square_packing_with_overlap_and_interval -presolve 2000 -solutions 1 -dimension 25
+     * ./bin/square_packing_with_overlap_and_interval -dimension 2 -sweep 24 -cache sweep.txt -time 600000
+     * ./bin/square_packing_with_overlap_and_interval -sink count -solutions 0 -dimension 12
+     * ./bin/square_packing_with_overlap_and_interval -sink count -symmetry dihedral -solutions 0 -dimension 12
+     * ./bin/square_packing_with_overlap_and_interval -sink binary -output solutions.bin -solutions 0 -dimension 12
+     * ./bin/square_packing_with_overlap_and_interval -search processes -threads 8 -solutions 1 -dimension 25
+     * ./bin/square_packing_with_overlap_and_interval -portfolio 0.2,0.35,0.5,0.35:afc -solutions 1 -dimension 25
      *
      */
     return 0;
@@ -0,0 +1,34 @@
+//
+// thread_count.hpp
+// Number of worker threads or processes for a -threads value, shared by square.cpp and
+// square_packing_with_overlap_and_interval.cpp.
+//
+
+#ifndef THREAD_COUNT_HPP
+#define THREAD_COUNT_HPP
+
+#include <algorithm>
+#include <thread>
+
+/**
+ * Number of threads for -threads n, with the rules of Gecode's search engines: 0 means one per processing unit,
+ * n >= 1 means n, 0 < n < 1 the fraction n of the processing units, -1 < n < 0 all but the fraction -n of them and
+ * n <= -1 all but -n of them. At least one.
+ */
+inline unsigned int threadCount(double n) {
+    double units = std::max(1u, std::thread::hardware_concurrency());
+    double t;
+    if (n == 0.0)
+        t = units;
+    else if (n >= 1.0)
+        t = n;
+    else if (n > 0.0)
+        t = n * units;
+    else if (n > -1.0)
+        t = (1.0 + n) * units;
+    else
+        t = units + n;
+    return t < 1.0 ? 1u : static_cast<unsigned int>(t);
+}
+
+#endif